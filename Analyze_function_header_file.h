@@ -0,0 +1,86 @@
+#ifndef ANALYZE_H // Include guard to prevent multiple inclusions of this header file
+#define ANALYZE_H
+
+#include <pthread.h>      // Include POSIX threads for the worker pool
+#include "Return_types.h" // Include user-defined types from types.h
+
+/*
+ * Structure to store information required for
+ * analysing a set of BMP images for LSB payloads
+ * Results are streamed to the report file as soon
+ * as each image is done
+ */
+
+#define COLOR_BOLD_SLOW_BLINKING_RED "\e[1;5;31m" // Define bold slow blinking red text color
+#define COLOR_RESET "\e[0m"                       // Define reset text formatting
+#define COLOR_BOLD_GREEN "\e[1;32m"               // Define bold green text color
+#define MAX_ANALYZE_THREADS 64                    // Define maximum number of worker threads
+#define RS_GROUP_SIZE 4                           // Define number of samples in one RS group
+
+typedef enum // Define an enumeration for report formats
+{
+    e_report_csv, // Comma separated values, one row per image
+    e_report_json // JSON array, one object per image
+} ReportFormat;
+
+typedef struct _AnalyzeResult // Define a structure to hold statistics of one image
+{
+    const char *image_fname; // Pointer to analysed image file name
+    Status status;           // Whether the image could be analysed
+    uint sample_count;       // Number of pixel bytes analysed
+    double chi_square;       // Chi-square statistic over pairs of values
+    double chi_probability;  // Probability that pairs of values were equalised by embedding
+    double rs_rate;          // RS analysis estimate of the fraction of LSBs carrying payload
+    int rs_done;             // Whether RS analysis was run, it needs direct colour pixels
+} AnalyzeResult;
+
+typedef struct _AnalyzeInfo // Define a structure to hold analysis information
+{
+    /* Input images */
+    char **image_fnames; // Pointer to list of image file names
+    int image_count;     // Number of images to analyse
+    int next_image;      // Index of the next image to hand to a worker
+
+    /* Worker pool */
+    int thread_count;     // Number of worker threads
+    pthread_mutex_t lock; // Lock protecting next_image and the report file
+
+    /* Report Info */
+    ReportFormat format;  // Format of the report
+    char *report_fname;   // Pointer to report file name, NULL for stdout
+    FILE *fptr_report;    // File pointer for report
+    int reported_count;   // Number of results written so far
+    int failed_count;     // Number of images that could not be analysed
+
+} AnalyzeInfo;
+
+/* Analysis function prototype */
+
+/* Read and validate Analyze args from argv */
+Status read_and_validate_analyze_args(int argc, char *argv[], AnalyzeInfo *anaInfo); // Validate analysis arguments
+
+/* Perform the analysis */
+Status do_analysis(AnalyzeInfo *anaInfo); // Analyse all images on the worker pool
+
+/* Analyse a single image */
+Status analyze_image(const char *image_fname, unsigned char **buffer, uint *buffer_size, AnalyzeResult *result); // Compute statistics for one image
+
+/* Build histogram of pixel values */
+void build_pixel_histogram(const unsigned char *data, uint size, uint histogram[256]); // Count occurrences of each byte value
+
+/* Chi-square attack */
+double chi_square_attack(const uint histogram[256], double *chi_square); // Return probability of embedding from pairs of values
+
+/* RS analysis */
+double rs_analysis(const unsigned char *data, uint size, uint width, uint pixel_size); // Return estimated embedding rate of rows of pixels
+
+/* Write one result to report */
+Status report_analyze_result(AnalyzeInfo *anaInfo, const AnalyzeResult *result); // Stream one result to the report
+
+/* Get bits per pixel */
+uint get_bmp_bits_per_pixel(FILE *fptr_image); // Get the bits per pixel of a BMP image
+
+/* Get offset of pixel data */
+uint get_bmp_pixel_offset(FILE *fptr_image); // Get the offset of the BMP pixel array
+
+#endif // End of include guard
@@ -0,0 +1,519 @@
+#include <stdio.h>  // Include standard input/output library
+#include <stdlib.h> // Include memory allocation and conversion functions
+#include <string.h> // Include string manipulation library
+#include <math.h>   // Include math functions for statistics
+#include <unistd.h> // Include sysconf to count online cores
+#include <limits.h> // Include UINT_MAX to bound pixel buffers
+#include "Analyze_function_header_file.h" // Include analyze header file
+#include "Return_types.h"  // Include types header file
+
+/* Function Definitions */
+
+/*
+ * Read and validate Analyze args from argv
+ * Inputs: -a [--csv|--json] [--threads N] [--output FILE] <image.bmp>...
+ * Output: List of images and report options stored in AnalyzeInfo
+ * Return Value: e_success or e_failure, on invalid arguments
+ */
+Status read_and_validate_analyze_args(int argc, char *argv[], AnalyzeInfo *anaInfo)
+{
+    anaInfo->image_fnames = &argv[2]; // Image names are collected in place over argv
+    anaInfo->image_count = 0;         // No images yet
+    anaInfo->next_image = 0;          // Start from the first image
+    anaInfo->thread_count = 0;        // Pick thread count from online cores
+    anaInfo->format = e_report_csv;   // CSV is the default report format
+    anaInfo->report_fname = NULL;     // Report goes to stdout by default
+    anaInfo->reported_count = 0;      // Nothing reported yet
+    anaInfo->failed_count = 0;        // No failures yet
+
+    for (int i = 2; i < argc; i++) // Loop through remaining arguments
+    {
+        if (!strcmp(argv[i], "--json")) // Check for JSON report
+        {
+            anaInfo->format = e_report_json; // Select JSON report
+        }
+        else if (!strcmp(argv[i], "--csv")) // Check for CSV report
+        {
+            anaInfo->format = e_report_csv; // Select CSV report
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) // Check for thread count
+        {
+            anaInfo->thread_count = atoi(argv[++i]); // Read thread count
+            if (anaInfo->thread_count <= 0)          // Check for invalid thread count
+            {
+                puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid thread count" COLOR_RESET); // Log error
+                return e_failure;                                                              // Return failure
+            }
+        }
+        else if (!strcmp(argv[i], "--output") && i + 1 < argc) // Check for report file
+        {
+            anaInfo->report_fname = argv[++i]; // Set report file name
+        }
+        else if (strstr(argv[i], ".bmp")) // Check if argument is a BMP image
+        {
+            anaInfo->image_fnames[anaInfo->image_count++] = argv[i]; // Add image to the list
+        }
+        else
+        {
+            fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid argument %s. Only BMP files are allowed\n" COLOR_RESET, argv[i]); // Log error
+            return e_failure;                                                                                                              // Return failure
+        }
+    }
+    if (anaInfo->image_count == 0) // Check if any image was given
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: No BMP images to analyse" COLOR_RESET); // Log error
+        return e_failure;                                                                 // Return failure
+    }
+
+    if (anaInfo->thread_count == 0) // Check if thread count was not given
+    {
+        anaInfo->thread_count = sysconf(_SC_NPROCESSORS_ONLN); // Use one thread per online core
+    }
+    if (anaInfo->thread_count > anaInfo->image_count) // Never start more threads than images
+    {
+        anaInfo->thread_count = anaInfo->image_count;
+    }
+    if (anaInfo->thread_count > MAX_ANALYZE_THREADS) // Limit thread count
+    {
+        anaInfo->thread_count = MAX_ANALYZE_THREADS;
+    }
+    if (anaInfo->thread_count < 1) // Always have at least one worker
+    {
+        anaInfo->thread_count = 1;
+    }
+
+    if (anaInfo->report_fname != NULL) // Check if report file was given
+    {
+        anaInfo->fptr_report = fopen(anaInfo->report_fname, "w"); // Open report file in write mode
+        if (anaInfo->fptr_report == NULL)                         // Check if file opening failed
+        {
+            perror("fopen");                                                                                                     // Print error message
+            fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open file %s\n" COLOR_RESET, anaInfo->report_fname); // Log error
+            return e_failure;                                                                                                    // Return failure
+        }
+    }
+    else
+    {
+        anaInfo->fptr_report = stdout; // Stream report to stdout
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Build histogram of pixel values
+ * Description: Four interleaved sub-histograms are filled so that
+ * neighbouring equal bytes do not serialise on the same counter,
+ * then they are summed into the final histogram
+ */
+void build_pixel_histogram(const unsigned char *data, uint size, uint histogram[256])
+{
+    uint sub[4][256];           // Sub-histograms, one per lane
+    uint i = 0;                 // Initialize index
+    memset(sub, 0, sizeof sub); // Clear sub-histograms
+    for (; i + 4 <= size; i += 4) // Process four bytes per iteration
+    {
+        sub[0][data[i]]++;     // Count byte in lane 0
+        sub[1][data[i + 1]]++; // Count byte in lane 1
+        sub[2][data[i + 2]]++; // Count byte in lane 2
+        sub[3][data[i + 3]]++; // Count byte in lane 3
+    }
+    for (; i < size; i++) // Count left over bytes
+    {
+        sub[0][data[i]]++;
+    }
+    for (int v = 0; v < 256; v++) // Sum lanes into final histogram
+    {
+        histogram[v] = sub[0][v] + sub[1][v] + sub[2][v] + sub[3][v];
+    }
+}
+
+/* Regularized upper incomplete gamma function Q(a, x) */
+static double gamma_q(double a, double x)
+{
+    if (x <= 0) // Whole distribution lies above zero
+    {
+        return 1.0;
+    }
+    if (x < a + 1) // Series expansion converges quickly here
+    {
+        double term = 1.0 / a, sum = term; // First term of series
+        for (int n = 1; n < 500; n++)      // Sum series terms
+        {
+            term *= x / (a + n);
+            sum += term;
+            if (fabs(term) < fabs(sum) * 1e-12) // Stop once converged
+            {
+                break;
+            }
+        }
+        return 1.0 - sum * exp(-x + a * log(x) - lgamma(a)); // Q = 1 - P
+    }
+    double b = x + 1 - a, c = 1e300, d = 1.0 / b, h = d; // Continued fraction (modified Lentz)
+    for (int n = 1; n < 500; n++)                        // Evaluate fraction terms
+    {
+        double an = -n * (n - a);
+        b += 2;
+        d = an * d + b;
+        d = fabs(d) < 1e-300 ? 1e-300 : d;
+        c = b + an / c;
+        c = fabs(c) < 1e-300 ? 1e-300 : c;
+        d = 1.0 / d;
+        h *= d * c;
+        if (fabs(d * c - 1.0) < 1e-12) // Stop once converged
+        {
+            break;
+        }
+    }
+    return exp(-x + a * log(x) - lgamma(a)) * h; // Scale fraction
+}
+
+/*
+ * Chi-square attack
+ * Description: LSB replacement equalises the counts of each pair of
+ * values (2k, 2k+1). The statistic compares the even counts with the
+ * pair mean; a probability close to 1 means the pairs are suspiciously
+ * equal, i.e. the LSBs most likely carry a payload
+ */
+double chi_square_attack(const uint histogram[256], double *chi_square)
+{
+    double chi = 0;        // Chi-square statistic
+    int categories = 0;    // Number of pairs taking part
+    for (int k = 0; k < 128; k++) // Loop through pairs of values
+    {
+        double expected = (histogram[2 * k] + histogram[2 * k + 1]) / 2.0; // Expected count if pair is equalised
+        if (expected > 4)                                                     // Skip pairs too small to be meaningful
+        {
+            double diff = histogram[2 * k] - expected;
+            chi += diff * diff / expected;
+            categories++;
+        }
+    }
+    *chi_square = chi; // Store statistic
+    if (categories < 2) // Not enough pairs to decide
+    {
+        return 0;
+    }
+    return gamma_q((categories - 1) / 2.0, chi / 2.0); // Upper tail of chi-square distribution
+}
+
+/* Smoothness of one RS group */
+static int rs_discrimination(const int *x)
+{
+    return abs(x[1] - x[0]) + abs(x[2] - x[1]) + abs(x[3] - x[2]); // Sum of neighbour differences
+}
+
+/*
+ * Count regular and singular groups for mask [0 1 1 0] and its negative
+ * Description: Groups are RS_GROUP_SIZE neighbouring pixels of one row,
+ * formed per colour channel; the alpha byte of 32 bit pixels is skipped
+ */
+static void rs_count_groups(const unsigned char *data, uint size, uint width, uint pixel_size, int flip_all, double counts[4])
+{
+    static const int mask[RS_GROUP_SIZE] = {0, 1, 1, 0}; // Flipping mask
+    long rm = 0, sm = 0, rnm = 0, snm = 0, groups = 0;   // Group counters
+    uint row_size = width * pixel_size;                  // Bytes of one row of pixels
+    uint span = RS_GROUP_SIZE * pixel_size;              // Bytes covered by one group of each channel
+    for (uint row = 0; row + row_size <= size; row += row_size) // Loop through rows
+    {
+        for (uint base = row; base + span <= row + row_size; base += span) // Loop through groups of pixels, never across rows
+        {
+            for (int channel = 0; channel < 3; channel++) // Groups are formed per colour channel
+            {
+                int x[RS_GROUP_SIZE], pos[RS_GROUP_SIZE], neg[RS_GROUP_SIZE];
+                for (int j = 0; j < RS_GROUP_SIZE; j++) // Build group and its flipped versions
+                {
+                    x[j] = data[base + pixel_size * j + channel] ^ flip_all; // Sample, optionally with LSB flipped
+                    pos[j] = mask[j] ? x[j] ^ 1 : x[j];                     // Apply F1 flipping
+                    neg[j] = mask[j] ? ((x[j] + 1) ^ 1) - 1 : x[j];         // Apply F-1 flipping
+                }
+                int f = rs_discrimination(x);     // Smoothness of group
+                int fp = rs_discrimination(pos);  // Smoothness after F1
+                int fn = rs_discrimination(neg);  // Smoothness after F-1
+                rm += fp > f;                     // Regular under mask
+                sm += fp < f;                     // Singular under mask
+                rnm += fn > f;                    // Regular under negative mask
+                snm += fn < f;                    // Singular under negative mask
+                groups++;
+            }
+        }
+    }
+    if (groups == 0) // Avoid division by zero on tiny images
+    {
+        groups = 1;
+    }
+    counts[0] = (double)rm / groups;  // Relative R_M
+    counts[1] = (double)sm / groups;  // Relative S_M
+    counts[2] = (double)rnm / groups; // Relative R_-M
+    counts[3] = (double)snm / groups; // Relative S_-M
+}
+
+/*
+ * RS analysis
+ * Input: Rows of width pixels of pixel_size bytes, without row padding
+ * Description: Counts regular and singular groups of the image and of
+ * the image with all LSBs flipped, and solves the Fridrich quadratic
+ * for the fraction of pixels carrying a payload
+ */
+double rs_analysis(const unsigned char *data, uint size, uint width, uint pixel_size)
+{
+    double orig[4], flip[4];                                 // Group statistics
+    rs_count_groups(data, size, width, pixel_size, 0, orig); // Statistics of image as is
+    rs_count_groups(data, size, width, pixel_size, 1, flip); // Statistics with all LSBs flipped
+    double d0 = orig[0] - orig[1];          // R_M - S_M
+    double d1 = flip[0] - flip[1];          // R_M - S_M after flipping
+    double n0 = orig[2] - orig[3];          // R_-M - S_-M
+    double n1 = flip[2] - flip[3];          // R_-M - S_-M after flipping
+    double a = 2 * (d1 + d0);               // Quadratic coefficients
+    double b = n0 - n1 - d1 - 3 * d0;
+    double c = d0 - n0;
+    double x;                               // Root of quadratic
+    if (fabs(a) < 1e-12) // Degenerates to a linear equation
+    {
+        if (fabs(b) < 1e-12)
+        {
+            return 0;
+        }
+        x = -c / b;
+    }
+    else
+    {
+        double disc = b * b - 4 * a * c; // Discriminant
+        if (disc < 0)                    // No real root, no measurable payload
+        {
+            return 0;
+        }
+        double r1 = (-b + sqrt(disc)) / (2 * a);
+        double r2 = (-b - sqrt(disc)) / (2 * a);
+        x = fabs(r1) < fabs(r2) ? r1 : r2; // Root with smaller magnitude
+    }
+    double rate = x / (x - 0.5); // Convert root to embedding rate
+    if (rate < 0)                // Clamp to a valid fraction
+    {
+        rate = 0;
+    }
+    if (rate > 1)
+    {
+        rate = 1;
+    }
+    return rate;
+}
+
+/*
+ * Analyse a single image
+ * Inputs: Image name and a reusable pixel buffer owned by the worker
+ * Output: Chi-square and RS statistics in result
+ * Description: Rows are stored padded to 4 bytes; the padding is
+ * squeezed out after reading so only pixel bytes are analysed. RS
+ * analysis is only run on 24 and 32 bit pixels, palette indices have
+ * no neighbour smoothness to measure
+ * Return Value: e_success or e_failure, on file errors
+ */
+Status analyze_image(const char *image_fname, unsigned char **buffer, uint *buffer_size, AnalyzeResult *result)
+{
+    memset(result, 0, sizeof *result); // Clear previous statistics
+    result->image_fname = image_fname; // Store image name
+    result->status = e_failure;        // Assume failure until done
+
+    FILE *fptr_image = fopen(image_fname, "r"); // Open image file in read mode
+    if (fptr_image == NULL)                     // Check if file opening failed
+    {
+        return e_failure;
+    }
+    char signature[2];                                                                  // Buffer to store BMP signature
+    if (fread(signature, 1, 2, fptr_image) != 2 || signature[0] != 0x42 || signature[1] != 0x4d) // Check if file is a BMP image
+    {
+        fclose(fptr_image);
+        return e_failure;
+    }
+    int width = 0, height = 0;                      // Image dimensions, height is negative for top-down images
+    fseek(fptr_image, 18, SEEK_SET);                // Move file pointer to width field
+    fread(&width, sizeof(width), 1, fptr_image);    // Read width (4 bytes)
+    fread(&height, sizeof(height), 1, fptr_image);  // Read height (4 bytes)
+    uint bpp = get_bmp_bits_per_pixel(fptr_image);  // Reuse BMP header parsing
+    uint offset = get_bmp_pixel_offset(fptr_image); // Find start of pixel data
+    unsigned long long row_size = (unsigned long long)width * (bpp / 8);         // Pixel bytes of one row
+    unsigned long long stride = ((unsigned long long)width * bpp + 31) / 32 * 4; // Bytes of one row with padding
+    unsigned long long rows = height < 0 ? -(long long)height : height;          // Number of rows
+    if (width <= 0 || bpp == 0 || bpp % 8 != 0 || stride * rows == 0 || stride * rows > UINT_MAX) // Check for a whole byte pixel array that fits a buffer
+    {
+        fclose(fptr_image);
+        return e_failure;
+    }
+    uint size = stride * rows; // Bytes of padded pixel array
+    if (size > *buffer_size)   // Grow worker buffer only when needed
+    {
+        unsigned char *grown = realloc(*buffer, size);
+        if (grown == NULL)
+        {
+            fclose(fptr_image);
+            return e_failure;
+        }
+        *buffer = grown;
+        *buffer_size = size;
+    }
+    fseek(fptr_image, offset, SEEK_SET);                 // Move file pointer to pixel data
+    rows = fread(*buffer, 1, size, fptr_image) / stride; // Read whole pixel array at once, keep complete rows
+    fclose(fptr_image);                                  // Done with the file
+    if (rows == 0)                                       // Check if any row was read
+    {
+        return e_failure;
+    }
+    for (uint r = 1; r < rows && stride != row_size; r++) // Squeeze out row padding
+    {
+        memmove(*buffer + r * row_size, *buffer + r * stride, row_size);
+    }
+    size = rows * row_size; // Pixel bytes analysed
+
+    uint histogram[256];                                                          // Histogram of pixel values
+    build_pixel_histogram(*buffer, size, histogram);                              // Count pixel values
+    result->sample_count = size;                                                  // Store number of samples
+    result->chi_probability = chi_square_attack(histogram, &result->chi_square); // Run chi-square attack
+    result->rs_done = bpp == 24 || bpp == 32;                                     // Groups need colour channels
+    if (result->rs_done)
+    {
+        result->rs_rate = rs_analysis(*buffer, size, width, bpp / 8); // Run RS analysis
+    }
+    result->status = e_success; // Mark success
+    return e_success;
+}
+
+/* Print a JSON string with quotes and backslashes escaped */
+static void print_json_string(FILE *fptr, const char *str)
+{
+    fputc('"', fptr);
+    for (; *str; str++)
+    {
+        if ((unsigned char)*str < 0x20) // Control characters are written as escapes
+        {
+            fprintf(fptr, "\\u%04x", *str);
+            continue;
+        }
+        if (*str == '"' || *str == '\\') // Escape special characters
+        {
+            fputc('\\', fptr);
+        }
+        fputc(*str, fptr);
+    }
+    fputc('"', fptr);
+}
+
+/* Print a CSV field in quotes with quotes doubled */
+static void print_csv_string(FILE *fptr, const char *str)
+{
+    fputc('"', fptr);
+    for (; *str; str++)
+    {
+        if (*str == '"') // Escape quote by doubling it
+        {
+            fputc('"', fptr);
+        }
+        fputc(*str, fptr);
+    }
+    fputc('"', fptr);
+}
+
+/*
+ * Write one result to report
+ * Description: Called by the workers under the pool lock, so rows
+ * appear in completion order and are flushed immediately
+ */
+Status report_analyze_result(AnalyzeInfo *anaInfo, const AnalyzeResult *result)
+{
+    FILE *out = anaInfo->fptr_report;                                   // Report file pointer
+    const char *status = result->status == e_success ? "ok" : "error"; // Status text
+    if (anaInfo->format == e_report_json)                               // JSON object per image
+    {
+        fputs(anaInfo->reported_count ? ",\n  {\"image\": " : "  {\"image\": ", out);
+        print_json_string(out, result->image_fname);
+        fprintf(out, ", \"status\": \"%s\", \"samples\": %u, \"chi_square\": %.4f, \"chi_probability\": %.6f, \"rs_rate\": ",
+                status, result->sample_count, result->chi_square, result->chi_probability);
+        result->rs_done ? fprintf(out, "%.6f}", result->rs_rate) : fputs("null}", out); // RS is not run on palette images
+    }
+    else // CSV row per image
+    {
+        print_csv_string(out, result->image_fname); // Names may hold commas, quotes or newlines
+        fprintf(out, ",%s,%u,%.4f,%.6f,", status, result->sample_count, result->chi_square, result->chi_probability);
+        result->rs_done ? fprintf(out, "%.6f\n", result->rs_rate) : fputs("\n", out); // RS is not run on palette images
+    }
+    fflush(out);                                           // Stream result right away
+    anaInfo->reported_count++;                             // Count reported rows
+    anaInfo->failed_count += result->status != e_success; // Count images that failed
+    return e_success;
+}
+
+/* Worker thread: analyses images until none are left */
+static void *analyze_worker(void *arg)
+{
+    AnalyzeInfo *anaInfo = arg;  // Shared analysis information
+    unsigned char *buffer = NULL; // Pixel buffer reused for every image
+    uint buffer_size = 0;         // Capacity of pixel buffer
+    AnalyzeResult result;         // Statistics of current image
+    for (;;)
+    {
+        pthread_mutex_lock(&anaInfo->lock);       // Take next image
+        int index = anaInfo->next_image++;
+        pthread_mutex_unlock(&anaInfo->lock);
+        if (index >= anaInfo->image_count)        // Stop when all images are taken
+        {
+            break;
+        }
+        analyze_image(anaInfo->image_fnames[index], &buffer, &buffer_size, &result); // Analyse image outside the lock
+        pthread_mutex_lock(&anaInfo->lock);                                          // Serialise report writes
+        report_analyze_result(anaInfo, &result);
+        pthread_mutex_unlock(&anaInfo->lock);
+    }
+    free(buffer); // Release worker buffer
+    return NULL;
+}
+
+/*
+ * Perform the analysis
+ * Description: Images are pulled from a shared index by a pool of
+ * worker threads; each worker keeps its own pixel buffer
+ */
+Status do_analysis(AnalyzeInfo *anaInfo)
+{
+    pthread_t threads[MAX_ANALYZE_THREADS]; // Worker threads
+    int started = 0;                        // Number of workers started
+    fprintf(stderr, COLOR_BOLD_GREEN "INFO: Analysing %d images on %d threads\n" COLOR_RESET, anaInfo->image_count, anaInfo->thread_count); // Log message
+    pthread_mutex_init(&anaInfo->lock, NULL);                                                                                               // Initialise pool lock
+    if (anaInfo->format == e_report_json)                                                                                                   // Open JSON array
+    {
+        fputs("[\n", anaInfo->fptr_report);
+    }
+    else // Write CSV header
+    {
+        fputs("image,status,samples,chi_square,chi_probability,rs_rate\n", anaInfo->fptr_report);
+    }
+    for (int i = 0; i < anaInfo->thread_count; i++) // Start workers
+    {
+        if (pthread_create(&threads[started], NULL, analyze_worker, anaInfo) == 0)
+        {
+            started++;
+        }
+    }
+    if (started == 0) // Fall back to analysing on the calling thread
+    {
+        analyze_worker(anaInfo);
+    }
+    for (int i = 0; i < started; i++) // Wait for workers
+    {
+        pthread_join(threads[i], NULL);
+    }
+    if (anaInfo->format == e_report_json) // Close JSON array
+    {
+        fputs(anaInfo->reported_count ? "\n]\n" : "]\n", anaInfo->fptr_report);
+    }
+    pthread_mutex_destroy(&anaInfo->lock); // Release pool lock
+    if (anaInfo->fptr_report != stdout)    // Close report file
+    {
+        fclose(anaInfo->fptr_report);
+    }
+    if (anaInfo->failed_count > 0) // Check if any image could not be analysed
+    {
+        fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %d of %d images could not be analysed\n" COLOR_RESET, anaInfo->failed_count, anaInfo->image_count); // Log error
+        return e_failure;                                                                                                                                     // Return failure
+    }
+    fputs(COLOR_BOLD_GREEN "INFO: ## Analysis Done ##\n" COLOR_RESET, stderr); // Log completion
+    return e_success;
+}
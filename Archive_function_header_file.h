@@ -0,0 +1,97 @@
+#ifndef ARCHIVE_H // Include guard to prevent multiple inclusions of this header file
+#define ARCHIVE_H
+
+#include "Return_types.h" // Include user-defined types from types.h
+#include "Magic_string.h" // Include shared block size
+#include "Palette_function_header_file.h" // Include palette types for 8 bit images
+
+/*
+ * Structure to store information required for
+ * packing many secret files into one source Image
+ * and for listing or extracting single entries
+ * The image holds a table of contents (name, offset,
+ * length, checksum) followed by the entry data
+ */
+
+#define COLOR_BOLD_SLOW_BLINKING_RED "\e[1;5;31m" // Define bold slow blinking red text color
+#define COLOR_BOLD_BLUE "\e[1;34m"                // Define bold blue text color
+#define COLOR_RESET "\e[0m"                       // Define reset text formatting
+#define COLOR_BOLD_GREEN "\e[1;32m"               // Define bold green text color
+#define MAX_ARCHIVE_ENTRIES 64                    // Define maximum number of files in one archive
+#define MAX_ARCHIVE_NAME 255                      // Define maximum length of an entry name
+
+typedef struct _ArchiveEntry // Define a structure to hold one table of contents entry
+{
+    char name[MAX_ARCHIVE_NAME + 1]; // Entry name without directories
+    char *fname;                     // Pointer to file packed under this entry, NULL when read from image
+    uint offset;                     // Offset of entry data from start of data area
+    uint length;                     // Size of entry data
+    uint checksum;                   // FNV-1a checksum of entry data
+} ArchiveEntry;
+
+typedef struct _ArchiveInfo // Define a structure to hold archive information
+{
+    /* Source Image info */
+    char *src_image_fname; // Pointer to source image file name
+    FILE *fptr_src_image;  // File pointer for source image
+    uint image_capacity;   // Capacity of the image to hold data
+    PaletteInfo palette;   // Palette and parity swap table of 8 bit images
+
+    /* Stego Image Info */
+    char *stego_image_fname; // Pointer to stego image file name
+    FILE *fptr_stego_image;  // File pointer for stego image
+
+    /* Table of contents */
+    ArchiveEntry entries[MAX_ARCHIVE_ENTRIES]; // Entries of the archive
+    uint entry_count;                          // Number of entries
+    long data_offset;                          // Offset of data area in the image
+
+    /* Extraction Info */
+    int list;           // Only print the table of contents
+    char *extract_name; // Pointer to name of entry to extract
+    char *output_fname; // Pointer to output file name for extracted entry
+
+} ArchiveInfo;
+
+/* Archive function prototype */
+
+/* Read and validate archive Encode args from argv */
+Status read_and_validate_archive_encode_args(int argc, char *argv[], ArchiveInfo *arcInfo); // Validate archive packing arguments
+
+/* Read and validate archive Decode args from argv */
+Status read_and_validate_archive_decode_args(int argc, char *argv[], ArchiveInfo *arcInfo); // Validate listing and extraction arguments
+
+/* Pack all entries into the image */
+Status do_archive_encoding(ArchiveInfo *arcInfo); // Write table of contents and entry data
+
+/* Print the table of contents */
+Status do_archive_listing(ArchiveInfo *arcInfo); // Read only the table of contents
+
+/* Extract one entry */
+Status do_archive_extraction(ArchiveInfo *arcInfo); // Seek straight to one entry and decode it
+
+/* Read the table of contents from the image */
+Status read_archive_table(ArchiveInfo *arcInfo); // Decode magic string, entry count and entries
+
+/* Checksum of entry data */
+uint archive_checksum(uint hash, const char *data, long size); // Continue FNV-1a checksum over data
+
+/* Get image size */
+uint get_image_size_for_bmp(FILE *fptr_image); // Get the size of the BMP image
+
+/* Get file size */
+uint get_file_size(FILE *fptr); // Get the size of a file
+
+/* Copy bmp image header */
+Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image); // Copy BMP header from source to destination
+
+/* Copy remaining image bytes from src to stego image after encoding */
+Status copy_remaining_img_data(FILE *fptr_src, FILE *fptr_dest); // Copy remaining image data from source to stego image
+
+/* Encode a block of bytes into LSB of image data */
+void encode_lsb_block(const char *data, long size, char *image_buffer, const PaletteInfo *palInfo); // Encode size bytes into 8 * size image bytes
+
+/* Decode a block of bytes from LSB of image data */
+Status decode_data_block(char *data, long size, const char *image_buffer); // Decode size bytes from 8 * size image bytes
+
+#endif // End of include guard
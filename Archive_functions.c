@@ -0,0 +1,406 @@
+#include <stdio.h>  // Include standard input/output library
+#include <string.h> // Include string manipulation library
+#include "Archive_function_header_file.h" // Include archive header file
+#include "Return_types.h"  // Include types header file
+#include "Magic_string.h" // Include Magic_string header file
+
+/* Function Definitions */
+
+/*
+ * Checksum of entry data
+ * Input: Running hash (2166136261 to start) and data
+ * Output: FNV-1a hash continued over data
+ */
+uint archive_checksum(uint hash, const char *data, long size)
+{
+    for (long i = 0; i < size; i++) // Loop through each byte of data
+    {
+        hash ^= (unsigned char)data[i]; // Mix in byte
+        hash *= 16777619u;              // Multiply by FNV prime
+    }
+    return hash; // Return running hash
+}
+
+/* Encode bytes into the next 8 * size image bytes and write them to the stego image */
+static Status archive_embed(ArchiveInfo *arcInfo, const char *data, long size)
+{
+    char str[MAX_DATA_CHUNK_SIZE * 8]; // Buffer to store image bytes of one block
+    while (size > 0)                   // Loop through data block by block
+    {
+        long n = size < MAX_DATA_CHUNK_SIZE ? size : MAX_DATA_CHUNK_SIZE; // Bytes in this block
+        if (fread(str, 1, n * 8, arcInfo->fptr_src_image) != (size_t)n * 8) // Read 8 image bytes per data byte
+        {
+            return e_failure; // Return failure
+        }
+        encode_lsb_block(data, n, str, &arcInfo->palette); // Encode block into LSBs
+        fwrite(str, 1, n * 8, arcInfo->fptr_stego_image); // Write encoded bytes to stego image
+        data += n;                                        // Move to next block
+        size -= n;
+    }
+    return e_success; // Return success
+}
+
+/* Encode a 32 bit integer, MSB first, like the single file header */
+static Status archive_embed_int(ArchiveInfo *arcInfo, uint value)
+{
+    char bytes[4] = {value >> 24, value >> 16, value >> 8, value}; // Split integer into bytes, MSB first
+    return archive_embed(arcInfo, bytes, 4);                      // Encode bytes into LSBs
+}
+
+/* Decode size bytes from the next 8 * size image bytes */
+static Status archive_extract(FILE *fptr_image, char *data, long size)
+{
+    char str[MAX_DATA_CHUNK_SIZE * 8]; // Buffer to store image bytes of one block
+    while (size > 0)                   // Loop through data block by block
+    {
+        long n = size < MAX_DATA_CHUNK_SIZE ? size : MAX_DATA_CHUNK_SIZE; // Bytes in this block
+        if (fread(str, 1, n * 8, fptr_image) != (size_t)n * 8)          // Read 8 image bytes per data byte
+        {
+            return e_failure; // Return failure
+        }
+        decode_data_block(data, n, str); // Decode block from LSBs
+        data += n;                       // Move to next block
+        size -= n;
+    }
+    return e_success; // Return success
+}
+
+/* Decode a 32 bit integer, MSB first */
+static Status archive_extract_int(FILE *fptr_image, uint *value)
+{
+    unsigned char bytes[4];                                     // Buffer to store integer bytes
+    if (archive_extract(fptr_image, (char *)bytes, 4) != e_success) // Decode integer bytes
+    {
+        return e_failure; // Return failure
+    }
+    *value = (uint)bytes[0] << 24 | bytes[1] << 16 | bytes[2] << 8 | bytes[3]; // Join bytes, MSB first
+    return e_success;                                                          // Return success
+}
+
+/* Open source image and check BMP signature */
+static Status archive_open_image(ArchiveInfo *arcInfo)
+{
+    arcInfo->fptr_src_image = fopen(arcInfo->src_image_fname, "r"); // Open source image file in read mode
+    if (arcInfo->fptr_src_image == NULL)                            // Check if file opening failed
+    {
+        perror("fopen");                                                                                                       // Print error message
+        fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open file %s\n" COLOR_RESET, arcInfo->src_image_fname); // Log error
+        return e_failure;                                                                                                      // Return failure
+    }
+    char data[2];                                                                // Buffer to read BMP signature
+    if (fread(data, 1, 2, arcInfo->fptr_src_image) != 2 || data[0] != 0x42 || data[1] != 0x4d) // Check if BMP signature is valid
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid Source Image File. Only BMP files are allowed" COLOR_RESET); // Log error
+        return e_failure;                                                                                              // Return failure
+    }
+    arcInfo->image_capacity = get_image_size_for_bmp(arcInfo->fptr_src_image); // Get image capacity
+    return read_bmp_palette(arcInfo->fptr_src_image, &arcInfo->palette);       // Prepare parity swaps for 8 bit images
+}
+
+/*
+ * Read and validate archive Encode args from argv
+ * Inputs: -e --archive <inputfile.bmp> <outputfile.bmp> <file>...
+ * Output: Table of contents with sizes, offsets and checksums
+ * Return Value: e_success or e_failure, on invalid arguments or capacity
+ */
+Status read_and_validate_archive_encode_args(int argc, char *argv[], ArchiveInfo *arcInfo)
+{
+    if (argc < 5 || !strstr(argv[2], ".bmp") || !strstr(argv[3], ".bmp")) // Check for source image, stego image and one file
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Use -e --archive <inputfile.bmp> <outputfile.bmp> <file>..." COLOR_RESET); // Log error
+        return e_failure;                                                                                                   // Return failure
+    }
+    arcInfo->src_image_fname = argv[2];   // Set source image file name
+    arcInfo->stego_image_fname = argv[3]; // Set stego image file name
+    arcInfo->entry_count = 0;             // No entries yet
+    if (argc - 4 > MAX_ARCHIVE_ENTRIES)   // Check number of files
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: At most %d files fit in one archive\n" COLOR_RESET, MAX_ARCHIVE_ENTRIES); // Log error
+        return e_failure;                                                                                                     // Return failure
+    }
+    if (archive_open_image(arcInfo) != e_success) // Open source image
+    {
+        return e_failure; // Return failure
+    }
+
+    unsigned long total_size = strlen(ARCHIVE_MAGIC_STRING) + 4; // Magic string and entry count
+    uint offset = 0;                                             // Offset of next entry in data area
+    for (int i = 4; i < argc; i++)                               // Loop through files to pack
+    {
+        ArchiveEntry *entry = &arcInfo->entries[arcInfo->entry_count]; // Entry for this file
+        char *name = strrchr(argv[i], '/');                             // Strip directories from name
+        name = name ? name + 1 : argv[i];
+        if (strlen(name) == 0 || strlen(name) > MAX_ARCHIVE_NAME) // Check name length
+        {
+            printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid entry name %s\n" COLOR_RESET, argv[i]); // Log error
+            return e_failure;                                                                           // Return failure
+        }
+        for (uint j = 0; j < arcInfo->entry_count; j++) // Check for duplicate names
+        {
+            if (!strcmp(arcInfo->entries[j].name, name))
+            {
+                printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Duplicate entry name %s\n" COLOR_RESET, name); // Log error
+                return e_failure;                                                                          // Return failure
+            }
+        }
+        FILE *fptr = fopen(argv[i], "r"); // Open file in read mode
+        if (fptr == NULL)                 // Check if file opening failed
+        {
+            perror("fopen");                                                                                    // Print error message
+            fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open file %s\n" COLOR_RESET, argv[i]); // Log error
+            return e_failure;                                                                                   // Return failure
+        }
+        strcpy(entry->name, name);              // Store entry name
+        entry->fname = argv[i];                 // Remember file to pack
+        entry->offset = offset;                 // Entry data follows the previous entry
+        entry->length = get_file_size(fptr);    // Get size of file
+        entry->checksum = 2166136261u;          // FNV-1a offset basis
+        rewind(fptr);                           // Checksum is needed before the table is written
+        char buffer[MAX_DATA_CHUNK_SIZE];       // Buffer to read file
+        size_t n;                               // Bytes read
+        while ((n = fread(buffer, 1, sizeof buffer, fptr)) > 0)
+        {
+            entry->checksum = archive_checksum(entry->checksum, buffer, n); // Continue checksum
+        }
+        fclose(fptr);                                              // Done with file for now
+        offset += entry->length;                                   // Next entry starts after this one
+        total_size += 4 + strlen(name) + 12 + entry->length;       // Table entry and data
+        arcInfo->entry_count++;                                    // One more entry
+    }
+    printf(COLOR_BOLD_GREEN "INFO: Checking for %s capacity to handle %u files\n" COLOR_RESET, arcInfo->src_image_fname, arcInfo->entry_count); // Log message
+    if (arcInfo->image_capacity < total_size * 8)                                                                                            // Check if image capacity is insufficient
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Image is too small to hold all files" COLOR_RESET); // Log error
+        return e_failure;                                                                             // Return failure
+    }
+    puts(COLOR_BOLD_GREEN "INFO: Done. Found OK" COLOR_RESET); // Log success
+    return e_success;                                          // Return success
+}
+
+/*
+ * Pack all entries into the image
+ * Description: Magic string, entry count and table of contents are
+ * encoded first, then the data of every entry back to back. Every
+ * exit goes through the end of the function, which closes the images
+ * and removes a partly written stego image
+ */
+Status do_archive_encoding(ArchiveInfo *arcInfo)
+{
+    Status status = e_failure;                                          // Nothing encoded yet
+    arcInfo->fptr_stego_image = fopen(arcInfo->stego_image_fname, "w"); // Open stego image file in write mode
+    if (arcInfo->fptr_stego_image == NULL)                              // Check if file opening failed
+    {
+        perror("fopen");                                                                                                         // Print error message
+        fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open file %s\n" COLOR_RESET, arcInfo->stego_image_fname); // Log error
+    }
+    else if (copy_bmp_header(arcInfo->fptr_src_image, arcInfo->fptr_stego_image) != e_success) // Copy BMP header
+    {
+        puts("\033[0;31mERROR: Failed to copy BMP header\033[0m"); // Log error
+    }
+    else
+    {
+        puts(COLOR_BOLD_GREEN "INFO: Encoding Archive Table of Contents" COLOR_RESET);          // Log message
+        status = archive_embed(arcInfo, ARCHIVE_MAGIC_STRING, strlen(ARCHIVE_MAGIC_STRING)); // Encode magic string
+    }
+    if (status == e_success)
+    {
+        status = archive_embed_int(arcInfo, arcInfo->entry_count); // Encode entry count
+    }
+    for (uint i = 0; i < arcInfo->entry_count && status == e_success; i++) // Encode table entries
+    {
+        ArchiveEntry *entry = &arcInfo->entries[i]; // Current entry
+        uint name_len = strlen(entry->name);        // Length of entry name
+        if (archive_embed_int(arcInfo, name_len) != e_success || archive_embed(arcInfo, entry->name, name_len) != e_success ||
+            archive_embed_int(arcInfo, entry->offset) != e_success || archive_embed_int(arcInfo, entry->length) != e_success ||
+            archive_embed_int(arcInfo, entry->checksum) != e_success)
+        {
+            status = e_failure; // Image ended inside the table
+        }
+    }
+    for (uint i = 0; i < arcInfo->entry_count && status == e_success; i++) // Encode entry data
+    {
+        ArchiveEntry *entry = &arcInfo->entries[i];                                                 // Current entry
+        printf(COLOR_BOLD_GREEN "INFO: Encoding %s (%u bytes)\n" COLOR_RESET, entry->name, entry->length); // Log message
+        FILE *fptr = fopen(entry->fname, "r");                                                      // Open file in read mode
+        if (fptr == NULL)                                                                           // Check if file opening failed
+        {
+            perror("fopen"); // Print error message
+            status = e_failure;
+            break;
+        }
+        char buffer[MAX_DATA_CHUNK_SIZE]; // Buffer to read file
+        long left = entry->length;        // Bytes still to encode
+        while (left > 0 && status == e_success)
+        {
+            long n = left < MAX_DATA_CHUNK_SIZE ? left : MAX_DATA_CHUNK_SIZE; // Bytes in this block
+            if (fread(buffer, 1, n, fptr) != (size_t)n)                       // Read block of file
+            {
+                status = e_failure; // File shrank since it was checked
+                break;
+            }
+            status = archive_embed(arcInfo, buffer, n); // Encode block into LSBs
+            left -= n;
+        }
+        fclose(fptr); // Done with file
+    }
+    if (status == e_success)
+    {
+        status = copy_remaining_img_data(arcInfo->fptr_src_image, arcInfo->fptr_stego_image); // Copy remaining image data
+    }
+    fclose(arcInfo->fptr_src_image); // Done with source image
+    arcInfo->fptr_src_image = NULL;
+    if (arcInfo->fptr_stego_image == NULL) // Stego image was never opened
+    {
+        return e_failure; // Return failure
+    }
+    if (fclose(arcInfo->fptr_stego_image) != 0) // Flush and close stego image
+    {
+        perror("fclose");   // Print error message
+        status = e_failure; // Unflushed output is a failure
+    }
+    arcInfo->fptr_stego_image = NULL; // Stego image is closed
+    if (status != e_success)
+    {
+        remove(arcInfo->stego_image_fname);                       // Remove partly written stego image
+        puts("\033[0;31mERROR: Failed to encode archive\033[0m"); // Log error
+        return e_failure;                                         // Return failure
+    }
+    puts(COLOR_BOLD_GREEN "INFO: ## Archive Encoding Done Successfully ##" COLOR_RESET); // Log completion
+    return e_success;                                                                   // Return success
+}
+
+/*
+ * Read and validate archive Decode args from argv
+ * Inputs: -d <inputfile.bmp> --list, or
+ *         -d <inputfile.bmp> --extract NAME <optional - outputfile>
+ * Return Value: e_success or e_failure, on invalid arguments
+ */
+Status read_and_validate_archive_decode_args(int argc, char *argv[], ArchiveInfo *arcInfo)
+{
+    if (!strstr(argv[2], ".bmp")) // Check if source image file is not BMP
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid File Format" COLOR_RESET); // Log error
+        return e_failure;                                                            // Return failure
+    }
+    arcInfo->src_image_fname = argv[2];                           // Set source image file name
+    arcInfo->output_fname = argc > 3 ? argv[3] : arcInfo->extract_name; // Extracted entry keeps its name by default
+    return archive_open_image(arcInfo);                           // Open source image
+}
+
+/*
+ * Read the table of contents from the image
+ * Description: Only the magic string, entry count and table are
+ * decoded; data_offset is left pointing at the first entry data
+ */
+Status read_archive_table(ArchiveInfo *arcInfo)
+{
+    uint magic_len = strlen(ARCHIVE_MAGIC_STRING); // Length of magic string
+    char magic[sizeof(ARCHIVE_MAGIC_STRING)];      // Buffer to store decoded magic string
+    fseek(arcInfo->fptr_src_image, get_bmp_pixel_offset(arcInfo->fptr_src_image), SEEK_SET); // Move file pointer to pixel data offset
+    if (archive_extract(arcInfo->fptr_src_image, magic, magic_len) != e_success || memcmp(magic, ARCHIVE_MAGIC_STRING, magic_len)) // Decode and compare magic string
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %s does not hold an archive\n" COLOR_RESET, arcInfo->src_image_fname); // Log error
+        return e_failure;                                                                                                 // Return failure
+    }
+    if (archive_extract_int(arcInfo->fptr_src_image, &arcInfo->entry_count) != e_success || arcInfo->entry_count > MAX_ARCHIVE_ENTRIES) // Decode entry count
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Corrupt archive table of contents" COLOR_RESET); // Log error
+        return e_failure;                                                                          // Return failure
+    }
+    for (uint i = 0; i < arcInfo->entry_count; i++) // Decode table entries
+    {
+        ArchiveEntry *entry = &arcInfo->entries[i]; // Current entry
+        uint name_len;                              // Length of entry name
+        if (archive_extract_int(arcInfo->fptr_src_image, &name_len) != e_success || name_len > MAX_ARCHIVE_NAME ||
+            archive_extract(arcInfo->fptr_src_image, entry->name, name_len) != e_success ||
+            archive_extract_int(arcInfo->fptr_src_image, &entry->offset) != e_success ||
+            archive_extract_int(arcInfo->fptr_src_image, &entry->length) != e_success ||
+            archive_extract_int(arcInfo->fptr_src_image, &entry->checksum) != e_success)
+        {
+            puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Corrupt archive table of contents" COLOR_RESET); // Log error
+            return e_failure;                                                                          // Return failure
+        }
+        entry->name[name_len] = '\0'; // Terminate entry name
+        entry->fname = NULL;          // Entry lives in the image
+    }
+    arcInfo->data_offset = ftell(arcInfo->fptr_src_image); // Entry data starts after the table
+    return e_success;                                      // Return success
+}
+
+/* Print the table of contents */
+Status do_archive_listing(ArchiveInfo *arcInfo)
+{
+    if (read_archive_table(arcInfo) != e_success) // Read only the table of contents
+    {
+        return e_failure; // Return failure
+    }
+    printf("%-32s %10s %10s %10s\n", "NAME", "OFFSET", "LENGTH", "CHECKSUM"); // Print table heading
+    for (uint i = 0; i < arcInfo->entry_count; i++)                          // Print each entry
+    {
+        ArchiveEntry *entry = &arcInfo->entries[i];
+        printf("%-32s %10u %10u   %08x\n", entry->name, entry->offset, entry->length, entry->checksum);
+    }
+    printf(COLOR_BOLD_GREEN "INFO: %u files in %s\n" COLOR_RESET, arcInfo->entry_count, arcInfo->src_image_fname); // Log summary
+    return e_success;                                                                                             // Return success
+}
+
+/*
+ * Extract one entry
+ * Description: After the table, the entry data is reached with one
+ * seek to data_offset + 8 * offset, so other entries are never decoded
+ */
+Status do_archive_extraction(ArchiveInfo *arcInfo)
+{
+    if (read_archive_table(arcInfo) != e_success) // Read only the table of contents
+    {
+        return e_failure; // Return failure
+    }
+    ArchiveEntry *entry = NULL;                     // Entry to extract
+    for (uint i = 0; i < arcInfo->entry_count; i++) // Look entry up by name
+    {
+        if (!strcmp(arcInfo->entries[i].name, arcInfo->extract_name))
+        {
+            entry = &arcInfo->entries[i];
+            break;
+        }
+    }
+    if (entry == NULL) // Check if entry exists
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: No entry %s in %s\n" COLOR_RESET, arcInfo->extract_name, arcInfo->src_image_fname); // Log error
+        return e_failure;                                                                                                              // Return failure
+    }
+    FILE *fptr_output = fopen(arcInfo->output_fname, "w"); // Open output file in write mode
+    if (fptr_output == NULL)                               // Check if file opening failed
+    {
+        perror("fopen");                                                                                                    // Print error message
+        fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open file %s\n" COLOR_RESET, arcInfo->output_fname); // Log error
+        return e_failure;                                                                                                   // Return failure
+    }
+    printf(COLOR_BOLD_GREEN "INFO: Extracting %s (%u bytes) to %s\n" COLOR_RESET, entry->name, entry->length, arcInfo->output_fname); // Log message
+    fseek(arcInfo->fptr_src_image, arcInfo->data_offset + (long)entry->offset * 8, SEEK_SET);                                       // Seek straight to entry data
+    char buffer[MAX_DATA_CHUNK_SIZE];                                                                                                // Buffer to store decoded block
+    uint checksum = 2166136261u;                                                                                                     // FNV-1a offset basis
+    long left = entry->length;                                                                                                       // Bytes still to decode
+    Status status = e_success;
+    while (left > 0)
+    {
+        long n = left < MAX_DATA_CHUNK_SIZE ? left : MAX_DATA_CHUNK_SIZE; // Bytes in this block
+        if (archive_extract(arcInfo->fptr_src_image, buffer, n) != e_success) // Decode block
+        {
+            status = e_failure; // Image ended inside entry
+            break;
+        }
+        checksum = archive_checksum(checksum, buffer, n); // Continue checksum
+        fwrite(buffer, 1, n, fptr_output);                // Write decoded block
+        left -= n;
+    }
+    fclose(fptr_output); // Close output file
+    if (status != e_success || checksum != entry->checksum) // Check entry data against table
+    {
+        remove(arcInfo->output_fname);                                                              // Remove corrupt output
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Checksum mismatch for %s\n" COLOR_RESET, entry->name); // Log error
+        return e_failure;                                                                           // Return failure
+    }
+    puts(COLOR_BOLD_GREEN "INFO: ## Extraction Done Successfully ##" COLOR_RESET); // Log completion
+    return e_success;                                                             // Return success
+}
@@ -0,0 +1,36 @@
+#ifndef CACHE_H // Include guard to prevent multiple inclusions of this header file
+#define CACHE_H
+
+#include "Encode_function_header_file.h" // Include encode header for EncodeInfo
+
+/*
+ * Content-addressed cache of stego images
+ * Entries are named after a hash of the cover bytes,
+ * the secret bytes and the encoding options, and are
+ * copied to the output on a hit. Entries are never
+ * hard links, so outputs can be changed freely
+ */
+
+#define CACHE_FORMAT_VERSION 3           // Bump when encoder output or entry storage changes for the same input
+#define CACHE_DEFAULT_SIZE_MB 1024       // Default size bound of the cache directory
+#define CACHE_STATS_FNAME "cache_stats"  // File in cache directory holding hit and miss counters
+#define CACHE_ENTRY_SUFFIX ".bmp"        // Suffix of cache entries
+
+/* Cache function prototype */
+
+/* Hash cover, secret and options into the cache key */
+Status cache_compute_key(EncodeInfo *encInfo); // Function to hash inputs and build cache entry name
+
+/* Place a cached stego image at the output name */
+Status cache_lookup(EncodeInfo *encInfo); // Function to copy a cached result, e_failure on a miss
+
+/* Store the committed stego image and evict old entries */
+Status cache_store(EncodeInfo *encInfo); // Function to add output to cache and enforce size bound
+
+/* Print and persist hit and miss counters */
+Status cache_update_stats(EncodeInfo *encInfo, int hit); // Function to count a hit or miss
+
+/* 64 bit hash of a block of data */
+unsigned long long cache_hash(unsigned long long hash, const unsigned char *data, size_t size); // Function to continue hashing over data
+
+#endif // End of include guard
@@ -0,0 +1,283 @@
+#include <stdio.h>    // Standard I/O library
+#include <stdlib.h>   // Memory allocation and sorting functions
+#include <string.h>   // String manipulation functions
+#include <dirent.h>   // Directory listing for eviction
+#include <unistd.h>   // ftruncate for the stats file
+#include <utime.h>    // utime to refresh entries on a hit
+#include <sys/stat.h> // stat for sizes, times and link counts
+#include <sys/file.h> // flock to serialize stats updates
+#include <fcntl.h>    // open flags for the stats file
+#include "Cache_function_header_file.h" // Header file for cache functions
+#include "Return_types.h"  // Include types header file
+#include "Magic_string.h" // Header file for common utilities
+
+/* Function Definitions */
+
+/*
+ * 64 bit hash of a block of data
+ * Description: Eight bytes are mixed per step, so hashing a cover
+ * image costs far less than encoding it
+ */
+unsigned long long cache_hash(unsigned long long hash, const unsigned char *data, size_t size)
+{
+    size_t i = 0;                 // Initialize index
+    for (; i + 8 <= size; i += 8) // Mix eight bytes per step
+    {
+        unsigned long long word;                            // Next eight bytes
+        memcpy(&word, data + i, 8);                         // Load without alignment requirement
+        hash ^= word * 0x9E3779B97F4A7C15ULL;               // Spread word over all bits
+        hash = (hash << 31 | hash >> 33) * 0x87C37B91114253D5ULL; // Rotate and multiply
+    }
+    for (; i < size; i++) // Mix left over bytes
+    {
+        hash ^= data[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash; // Return running hash
+}
+
+/* Hash a whole file, leaving its file pointer at the start */
+static unsigned long long cache_hash_file(unsigned long long hash, FILE *fptr)
+{
+    unsigned char buffer[65536]; // Buffer to read file
+    size_t n;                    // Bytes read
+    rewind(fptr);                // Hash from the first byte
+    while ((n = fread(buffer, 1, sizeof buffer, fptr)) > 0)
+    {
+        hash = cache_hash(hash, buffer, n); // Continue hash
+    }
+    rewind(fptr); // Encoding starts from the first byte again
+    return hash;  // Return running hash
+}
+
+/*
+ * Copy a file
+ * Description: Entries are always copies, never hard links, so an
+ * output that is later updated in place cannot change a cache entry
+ */
+static Status cache_copy_file(const char *src_fname, const char *dest_fname)
+{
+    FILE *src = fopen(src_fname, "r"); // Open source in read mode
+    if (src == NULL)
+    {
+        return e_failure; // Return failure
+    }
+    FILE *dest = fopen(dest_fname, "w"); // Open destination in write mode
+    if (dest == NULL)
+    {
+        fclose(src);
+        return e_failure; // Return failure
+    }
+    char buffer[65536];       // Buffer to copy blocks
+    size_t n;                 // Bytes read
+    Status status = e_success;
+    while ((n = fread(buffer, 1, sizeof buffer, src)) > 0)
+    {
+        if (fwrite(buffer, 1, n, dest) != n) // Write block
+        {
+            status = e_failure;
+            break;
+        }
+    }
+    fclose(src);
+    if (fclose(dest) != 0 || status != e_success) // Flush destination
+    {
+        remove(dest_fname); // Remove partial copy
+        return e_failure;   // Return failure
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Hash cover, secret and options into the cache key
+ * Description: Everything that changes the encoder output is part of
+ * the key; the entry name is the key in hex inside the cache directory
+ */
+Status cache_compute_key(EncodeInfo *encInfo)
+{
+    char options[256]; // Encoding options that change the output
+    int len = snprintf(options, sizeof options, "v%d|%s|%s|%ld|m%u", CACHE_FORMAT_VERSION, MAGIC_STRING,
+                       encInfo->extn_secret_file, encInfo->size_secret_file, encInfo->matrix_rate);
+    unsigned long long hash = 0xCBF29CE484222325ULL;                              // Seed
+    hash = cache_hash(hash, (const unsigned char *)options, len);                 // Hash options
+    hash = cache_hash_file(hash, encInfo->fptr_src_image);                       // Hash cover bytes
+    hash = cache_hash_file(hash, encInfo->fptr_secret);                          // Hash secret bytes
+    hash ^= hash >> 33;                                                          // Final avalanche
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    if (snprintf(encInfo->cache_fname, sizeof encInfo->cache_fname, "%s/%016llx" CACHE_ENTRY_SUFFIX, encInfo->cache_dir, hash) >= (int)sizeof encInfo->cache_fname) // Build entry name
+    {
+        return e_failure; // Return failure
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Place a cached stego image at the output name
+ * Description: The entry is copied next to the output first and then
+ * renamed over it, so a failed copy or rename leaves the job free to encode
+ * Return Value: e_success on a hit, e_failure on a miss
+ */
+Status cache_lookup(EncodeInfo *encInfo)
+{
+    struct stat st;                                // Status of cache entry
+    if (stat(encInfo->cache_fname, &st) != 0)      // Check if entry exists
+    {
+        return e_failure; // Miss
+    }
+    const char *final_fname = encInfo->output_fname ? encInfo->output_fname : encInfo->stego_image_fname; // Name the output ends up under
+    char copy_fname[sizeof encInfo->staging_fname + 8];                                                    // Temporary name of copied entry
+    snprintf(copy_fname, sizeof copy_fname, "%s.cache", final_fname);
+    remove(copy_fname);                                              // Remove leftovers of an interrupted run
+    if (cache_copy_file(encInfo->cache_fname, copy_fname) != e_success) // Copy entry next to output
+    {
+        return e_failure; // Treat as a miss
+    }
+    if (rename(copy_fname, final_fname) != 0) // Replace output with entry
+    {
+        remove(copy_fname); // Remove copied entry
+        return e_failure;   // Treat as a miss
+    }
+    fclose(encInfo->fptr_stego_image); // Opened output is not needed
+    encInfo->fptr_stego_image = NULL;
+    if (encInfo->output_fname != NULL) // Staged output is never committed
+    {
+        remove(encInfo->stego_image_fname);
+    }
+    utime(encInfo->cache_fname, NULL); // Mark entry as recently used
+    printf(COLOR_BOLD_GREEN "INFO: Cache hit, %s copied from %s\n" COLOR_RESET, final_fname, encInfo->cache_fname); // Log message
+    return e_success;                                                                                               // Return success
+}
+
+typedef struct _CacheEntry // Structure to hold one entry during eviction
+{
+    char name[256]; // Entry file name
+    off_t size;     // Entry size in bytes
+    long long mtime; // Last time entry was stored or hit, in nanoseconds
+} CacheEntry;
+
+/* Order entries from least to most recently used */
+static int cache_entry_cmp(const void *a, const void *b)
+{
+    const CacheEntry *x = a, *y = b;
+    return (x->mtime > y->mtime) - (x->mtime < y->mtime);
+}
+
+/* Remove least recently used entries until the cache fits its bound */
+static void cache_evict(EncodeInfo *encInfo)
+{
+    DIR *dir = opendir(encInfo->cache_dir); // Open cache directory
+    if (dir == NULL)
+    {
+        return;
+    }
+    CacheEntry *entries = NULL;       // Entries found
+    size_t count = 0, capacity = 0;   // Number of entries and allocated slots
+    long long total = 0;              // Bytes held by entries
+    char path[FILENAME_MAX];          // Path of an entry
+    struct dirent *d;
+    while ((d = readdir(dir)) != NULL) // Collect entries
+    {
+        size_t len = strlen(d->d_name);
+        if (len < sizeof CACHE_ENTRY_SUFFIX || len >= sizeof entries->name || strcmp(d->d_name + len - strlen(CACHE_ENTRY_SUFFIX), CACHE_ENTRY_SUFFIX)) // Only cache entries count
+        {
+            continue;
+        }
+        struct stat st;
+        snprintf(path, sizeof path, "%s/%s", encInfo->cache_dir, d->d_name);
+        if (stat(path, &st) != 0)
+        {
+            continue;
+        }
+        if (count == capacity) // Grow entry list
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            CacheEntry *grown = realloc(entries, capacity * sizeof *entries);
+            if (grown == NULL)
+            {
+                break;
+            }
+            entries = grown;
+        }
+        strcpy(entries[count].name, d->d_name);
+        entries[count].size = st.st_size;
+        entries[count].mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+        total += st.st_size;
+        count++;
+    }
+    closedir(dir);
+    if (total > encInfo->cache_max_size) // Check size bound
+    {
+        qsort(entries, count, sizeof *entries, cache_entry_cmp);           // Oldest first
+        for (size_t i = 0; i < count && total > encInfo->cache_max_size; i++) // Evict until bound holds
+        {
+            snprintf(path, sizeof path, "%s/%s", encInfo->cache_dir, entries[i].name);
+            if (remove(path) == 0)
+            {
+                total -= entries[i].size;
+                printf(COLOR_BOLD_GREEN "INFO: Cache evicted %s\n" COLOR_RESET, path); // Log eviction
+            }
+        }
+    }
+    free(entries); // Release entry list
+}
+
+/*
+ * Store the committed stego image and evict old entries
+ * Description: The output is copied into the cache under a temporary
+ * name and renamed, so readers never see a partial entry
+ */
+Status cache_store(EncodeInfo *encInfo)
+{
+    char tmp_fname[sizeof encInfo->cache_fname + 8];                         // Temporary entry name
+    snprintf(tmp_fname, sizeof tmp_fname, "%s.tmp", encInfo->cache_fname);
+    remove(tmp_fname);                                                       // Remove leftovers of an interrupted run
+    if (cache_copy_file(encInfo->stego_image_fname, tmp_fname) != e_success || rename(tmp_fname, encInfo->cache_fname) != 0) // Publish entry atomically
+    {
+        remove(tmp_fname);
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to store %s in cache\n" COLOR_RESET, encInfo->stego_image_fname); // Log error
+        return e_failure;                                                                                                   // Return failure
+    }
+    cache_evict(encInfo); // Keep cache within its bound
+    return e_success;     // Return success
+}
+
+/*
+ * Print and persist hit and miss counters
+ * Description: The stats file is locked while it is read and rewritten,
+ * so jobs sharing a cache directory do not lose counts
+ */
+Status cache_update_stats(EncodeInfo *encInfo, int hit)
+{
+    char fname[FILENAME_MAX];   // Path of stats file
+    long hits = 0, misses = 0;  // Counters
+    snprintf(fname, sizeof fname, "%s/" CACHE_STATS_FNAME, encInfo->cache_dir);
+    int fd = open(fname, O_RDWR | O_CREAT, 0644);            // Open or create stats file
+    FILE *fptr = fd >= 0 ? fdopen(fd, "r+") : NULL;          // Buffered access to counters
+    if (fptr == NULL)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open %s\n" COLOR_RESET, fname); // Log error
+        return e_failure;                                                                   // Return failure
+    }
+    flock(fd, LOCK_EX); // Wait for other jobs updating the counters
+    if (fscanf(fptr, "hits %ld misses %ld", &hits, &misses) != 2)
+    {
+        hits = misses = 0; // Start over on a new or corrupt file
+    }
+    hits += hit != 0;   // Count this job
+    misses += hit == 0;
+    rewind(fptr);       // Write counters back from the start
+    if (ftruncate(fd, 0) == 0)
+    {
+        fprintf(fptr, "hits %ld misses %ld\n", hits, misses);
+    }
+    fflush(fptr);        // Counters reach the file before the lock is released
+    flock(fd, LOCK_UN);
+    fclose(fptr);
+    printf(COLOR_BOLD_GREEN "INFO: Cache %s. Hits: %ld, Misses: %ld\n" COLOR_RESET, hit ? "hit" : "miss", hits, misses); // Log statistics
+    return e_success;                                                                                                  // Return success
+}
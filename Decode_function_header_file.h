@@ -2,6 +2,8 @@
 #define DECODE_H
 
 #include "Return_types.h" // Include user-defined types from types.h
+#include "Magic_string.h" // Include shared block size
+#include "Matrix_function_header_file.h" // Include matrix embedding functions
 
 /*
  * Structure to store information required for
@@ -36,10 +38,18 @@ typedef struct _DecodeInfo // Define a structure to hold decoding information
     char secret_data[MAX_SECRET_BUF_SIZE]; // Buffer to hold secret data
     long size_secret_file; // Size of the secret file
 
+    long data_offset;      // Offset of first secret data block in the image
+    uint matrix_rate;      // Secret bits per group of image bytes, 0 for plain LSB
+
     /* Stego Image Info */
     char *stego_image_fname; // Pointer to stego image file name
     FILE *fptr_stego_image;  // File pointer for stego image
 
+    /* Range Info */
+    char *range_spec;  // Pointer to OFFSET:LENGTH of secret bytes to extract, NULL for whole file
+    long range_offset; // First secret byte to extract
+    long range_length; // Number of secret bytes to extract
+
 } DecodeInfo;
 
 /* Decoding function prototype */
@@ -56,6 +66,13 @@ Status decode_open_files(DecodeInfo *decInfo); // Open input and output files fo
 /* Get image size */
 uint get_image_size_for_bmp(FILE *fptr_image); // Get the size of the BMP image
 
+/* Decode a block of bytes from LSB of image data */
+Status decode_data_block(char *data, long size, const char *image_buffer); // Decode size bytes from 8 * size image bytes
+long decode_compare_block(const char *data, long size, const char *image_buffer); // Count bytes that do not decode as expected
+
+/* Get offset of pixel data */
+uint get_bmp_pixel_offset(FILE *fptr_image); // Get the offset of the BMP pixel array
+
 /* Get file size */
 uint get_file_size(FILE *fptr); // Get the size of a file
 
@@ -77,6 +94,9 @@ Status decode_secret_file_size(long file_size, DecodeInfo *decInfo); // Decode s
 /* Encode secret file data*/
 Status decode_secret_file_data(DecodeInfo *decInfo); // Decode secret file data
 
+/* Decode a range of secret file data */
+Status decode_secret_data_range(long offset, long length, DecodeInfo *decInfo); // Decode secret bytes [offset, offset + length) only
+
 /* Encode function, which does the real encoding */
 Status decode_data_to_image(char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image); // Decode data into the image
 
@@ -3,6 +3,11 @@
 #include "Return_types.h"  // Include types header file
 #include "Magic_string.h" // Include Magic_string header file
 #include <string.h> // Include string manipulation library
+#include <stdlib.h> // Include strtol for parsing the range
+#include <stdint.h> // Include fixed width integers for word decoding
+#ifdef __SSE2__
+#include <emmintrin.h> // Include SSE2 intrinsics, present on every x86-64 target
+#endif
 
 /* Function Definitions */
 
@@ -44,6 +49,22 @@ Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo)
         puts(COLOR_BOLD_GREEN "INFO: Opening decoded.txt" COLOR_RESET);                                        // Print opening default file message
         decInfo->stego_image_fname = "decoded.txt";                                                            // Assign default output file name
     }
+    if (decInfo->range_spec != NULL) // Check if only a range of the secret file is wanted
+    {
+        char *end;                                                // Pointer to end of parsed number
+        decInfo->range_offset = strtol(decInfo->range_spec, &end, 10); // Parse offset
+        if (*end != ':' || decInfo->range_offset < 0)              // Offset must be followed by ':'
+        {
+            puts(COLOR_BOLD_RED "ERROR: Invalid range. Use --range OFFSET:LENGTH" COLOR_RESET); // Print error message
+            return e_failure;                                                                  // Return failure
+        }
+        decInfo->range_length = strtol(end + 1, &end, 10); // Parse length
+        if (*end != '\0' || decInfo->range_length <= 0)    // Length must be positive
+        {
+            puts(COLOR_BOLD_RED "ERROR: Invalid range. Use --range OFFSET:LENGTH" COLOR_RESET); // Print error message
+            return e_failure;                                                                  // Return failure
+        }
+    }
     decode_open_files(decInfo);                 // Open required files for decoding
     char data[2];                               // Buffer to store BMP signature
     fread(data, 1, 2, decInfo->fptr_src_image); // Read first 2 bytes of the image file
@@ -74,6 +95,7 @@ Status do_decoding(DecodeInfo *decInfo)
                     {
                         puts(COLOR_BOLD_GREEN "INFO: Done" COLOR_RESET);                             // Print success message
                         puts(COLOR_BOLD_GREEN "INFO: ## Decoding Done Successfully ##" COLOR_RESET); // Print decoding completion message
+                        return e_success;                                                            // Return success
                     }
                     else
                     {
@@ -151,6 +173,97 @@ Status decode_byte_tolsb(char *data, char *image_buffer)
     *data = ch; // Assign decoded byte to data
 }
 
+/*
+ * Decode one byte from LSBs of 8 image bytes
+ * Output: Same bit layout as decode_byte_tolsb
+ * Description: The image bytes are loaded as one little endian word, like
+ * the BMP header fields. The multiply moves the LSB of image byte j to
+ * bit 63 - j with no carries, so the top byte of the product is the
+ * secret byte, MSB first
+ */
+static char decode_lsb_word(const char *image_buffer)
+{
+    uint64_t lsb;                               // LSBs of the 8 image bytes
+    memcpy(&lsb, image_buffer, 8);              // Load 8 image bytes at once
+    lsb &= 0x0101010101010101ULL;               // Keep LSB of every image byte
+    return (lsb * 0x8040201008040201ULL) >> 56; // Gather LSBs, first image byte into bit 7
+}
+
+/*
+ * Decode 8 bytes from LSBs of 64 image bytes
+ * Output: Decoded bytes, first byte lowest
+ * Description: With SSE2, 16 image bytes give 2 bytes at once. The
+ * shuffles reverse the 16 bit words of each 8 image bytes and the rotate
+ * swaps the bytes of a word while moving their LSBs to bit 7, so the
+ * byte mask collects the LSBs MSB first, as decode_lsb_word does
+ */
+static uint64_t decode_lsb_group(const char *image_buffer)
+{
+    uint64_t bytes = 0;         // Decoded bytes
+    for (int j = 0; j < 4; j++) // Loop through 16 image bytes at a time
+    {
+#ifdef __SSE2__
+        __m128i v = _mm_loadu_si128((const __m128i *)(image_buffer + 16 * j)); // Load 16 image bytes
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1B), 0x1B);          // Reverse words of each 8 bytes
+        v = _mm_or_si128(_mm_srli_epi16(v, 1), _mm_slli_epi16(v, 15));         // Swap bytes, LSBs into bit 7
+        bytes |= (uint64_t)_mm_movemask_epi8(v) << 16 * j;                     // Collect 2 bytes
+#else
+        bytes |= (uint64_t)(unsigned char)decode_lsb_word(image_buffer + 16 * j) << 16 * j;          // Collect first byte
+        bytes |= (uint64_t)(unsigned char)decode_lsb_word(image_buffer + 16 * j + 8) << (16 * j + 8); // Collect second byte
+#endif
+    }
+    return bytes; // Return decoded bytes
+}
+
+/*
+ * Decode a block of bytes from LSBs of image data
+ * Input: 8 * size bytes of image data
+ * Output: size decoded bytes
+ */
+Status decode_data_block(char *data, long size, const char *image_buffer)
+{
+    long i = 0;                   // Bytes decoded
+    for (; i + 8 <= size; i += 8) // Loop through groups of 8 bytes of data
+    {
+        uint64_t bytes = decode_lsb_group(image_buffer + 8 * i); // Decode group
+        memcpy(data + i, &bytes, 8);                             // Store group, first byte lowest
+    }
+    for (; i < size; i++) // Loop through bytes after the last group
+    {
+        data[i] = decode_lsb_word(image_buffer + 8 * i); // Decode byte
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Check a block of bytes against LSBs of image data
+ * Input: size expected bytes and 8 * size bytes of image data
+ * Return Value: Number of bytes that do not decode as expected
+ * Description: Decodes like decode_data_block and compares in the same
+ * loop, so --verify needs no buffer and no second pass over the block.
+ * Bytes are compared 8 at a time and only counted one by one when a
+ * group of 8 differs
+ */
+long decode_compare_block(const char *data, long size, const char *image_buffer)
+{
+    long mismatches = 0; // Bytes that differ
+    long i = 0;          // Bytes compared
+    for (; i + 8 <= size; i += 8) // Loop through groups of 8 bytes of data
+    {
+        uint64_t got = decode_lsb_group(image_buffer + 8 * i), want; // Decoded and expected bytes
+        memcpy(&want, data + i, 8);                                   // Load expected bytes the same way
+        for (int j = 0; j < 8 && got != want; j++) // Count bytes of a differing group
+        {
+            mismatches += (char)(got >> 8 * j) != data[i + j];
+        }
+    }
+    for (; i < size; i++) // Loop through bytes after the last group
+    {
+        mismatches += decode_lsb_word(image_buffer + 8 * i) != data[i]; // Count byte if it does not decode back
+    }
+    return mismatches; // Return number of mismatches
+}
+
 Status decode_magic_string(char *magic_string, DecodeInfo *decInfo)
 {
     puts(COLOR_BOLD_GREEN "INFO: Decoding Magic String Signature" COLOR_RESET); // Print decoding magic string message
@@ -158,7 +271,7 @@ Status decode_magic_string(char *magic_string, DecodeInfo *decInfo)
     char str[8];                                                                // Buffer to store 8 bits
     int lem = strlen(magic_string);                                             // Get length of magic string
     char data[lem];                                                             // Buffer to store decoded magic string
-    fseek(decInfo->fptr_src_image, 54, SEEK_SET);                               // Move file pointer to pixel data offset
+    fseek(decInfo->fptr_src_image, get_bmp_pixel_offset(decInfo->fptr_src_image), SEEK_SET); // Move file pointer to pixel data offset
     for (i = 0; i < lem; i++)                                                   // Loop through magic string length
     {
         fread(str, 1, 8, decInfo->fptr_src_image); // Read 8 bits from image
@@ -169,10 +282,16 @@ Status decode_magic_string(char *magic_string, DecodeInfo *decInfo)
 
 Status decode_secret_file_extn_size(long int size, DecodeInfo *decInfo)
 {
-    char str1[32];                               // Buffer to store 32 bits
-    fread(str1, 1, 32, decInfo->fptr_src_image); // Read 32 bits from image
-    decode_int_tolsb(&size, str1);               // Decode integer from LSB
-    return e_success;                            // Return success
+    char str1[32];                                                           // Buffer to store 32 bits
+    fread(str1, 1, 32, decInfo->fptr_src_image);                             // Read 32 bits from image
+    decode_int_tolsb(&size, str1);                                           // Decode integer from LSB
+    decInfo->matrix_rate = (size >> EMBED_MODE_SHIFT) & EMBED_MODE_MASK;     // Embedding mode is kept above the size
+    if (decInfo->matrix_rate != 0 && (decInfo->matrix_rate < MATRIX_MIN_RATE || decInfo->matrix_rate > MATRIX_MAX_RATE)) // Check embedding mode
+    {
+        printf(COLOR_BOLD_RED "ERROR: Unknown embedding mode %u\n" COLOR_RESET, decInfo->matrix_rate); // Print error message
+        return e_failure;                                                                               // Return failure
+    }
+    return e_success; // Return success
 }
 
 Status decode_secret_file_extn(char *ext, DecodeInfo *decInfo)
@@ -194,21 +313,85 @@ Status decode_secret_file_size(long file_size, DecodeInfo *decInfo)
     char data[32];                                                                                    // Buffer to store 32 bits
     fread(data, 1, 32, decInfo->fptr_src_image);                                                      // Read 32 bits from image
     decode_int_tolsb(&decInfo->size_secret_file, data);                                               // Decode integer from LSB
+    decInfo->data_offset = ftell(decInfo->fptr_src_image);                                            // Secret data starts right after the size
     return e_success;                                                                                 // Return success
 }
 
+/*
+ * Decode a range of matrix embedded secret file data
+ * Description: The encoder starts every MATRIX_CHUNK_SIZE(K) bytes on a
+ * group boundary, so the chunk holding the range is reached with a single
+ * seek and extracted with matrix_extract_block like --verify does. Bytes
+ * of the first chunk that come before the range are dropped
+ */
+static Status decode_matrix_data_range(long offset, long length, DecodeInfo *decInfo)
+{
+    uint k = decInfo->matrix_rate;                    // Secret bits per group
+    long chunk = MATRIX_CHUNK_SIZE(k);                // Secret bytes per block
+    char str[MATRIX_CHUNK_GROUPS * MATRIX_MAX_GROUP]; // Buffer to store image bytes of one block
+    char sec[MATRIX_CHUNK_SIZE(MATRIX_MAX_RATE)];     // Buffer to store decoded secret bytes of one block
+    long skip = offset % chunk;                       // Bytes of first block before the range
+    fseek(decInfo->fptr_src_image, decInfo->data_offset + offset / chunk * MATRIX_CHUNK_GROUPS * matrix_group_size(k), SEEK_SET); // Move file pointer to first block of range
+    while (length > 0)                                                                               // Loop through range block by block
+    {
+        long size = skip + length < chunk ? skip + length : chunk; // Bytes to extract from this block
+        long cover = matrix_cover_size(size, k);                   // Image bytes of their groups
+        if (fread(str, 1, cover, decInfo->fptr_src_image) != (size_t)cover) // Read image bytes of the groups
+        {
+            puts(COLOR_BOLD_RED "ERROR: Image ends before secret file data" COLOR_RESET); // Print error message
+            return e_failure;                                                           // Return failure
+        }
+        matrix_extract_block(sec, size, str, k);                      // Collect syndromes into bytes
+        fwrite(sec + skip, 1, size - skip, decInfo->fptr_stego_image); // Write bytes of the range
+        length -= size - skip;                                         // Move to next block
+        skip = 0;                                                      // Later blocks are used whole
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Decode a range of secret file data
+ * Inputs: First secret byte and number of bytes to decode
+ * Description: Every secret byte takes 8 image bytes from data_offset,
+ * so the range is reached with a single seek and read in blocks
+ */
+Status decode_secret_data_range(long offset, long length, DecodeInfo *decInfo)
+{
+    char str[MAX_DATA_CHUNK_SIZE * 8]; // Buffer to store image bytes of one block
+    char sec[MAX_DATA_CHUNK_SIZE];     // Buffer to store decoded secret bytes of one block
+    if (offset < 0 || length < 0 || offset > decInfo->size_secret_file || length > decInfo->size_secret_file - offset) // Check range lies inside secret file
+    {
+        printf(COLOR_BOLD_RED "ERROR: Range %ld:%ld is outside the %ld byte secret file\n" COLOR_RESET, offset, length, decInfo->size_secret_file); // Print error message
+        return e_failure;                                                                                                                         // Return failure
+    }
+    if (decInfo->matrix_rate) // Secret data is matrix embedded
+    {
+        return decode_matrix_data_range(offset, length, decInfo); // Decode groups of range
+    }
+    fseek(decInfo->fptr_src_image, decInfo->data_offset + offset * 8, SEEK_SET); // Move file pointer to first image byte of range
+    while (length > 0)                                                           // Loop through range block by block
+    {
+        long size = length < MAX_DATA_CHUNK_SIZE ? length : MAX_DATA_CHUNK_SIZE;       // Bytes in this block
+        if (fread(str, 1, size * 8, decInfo->fptr_src_image) != (size_t)size * 8)      // Read 8 bits per secret byte
+        {
+            puts(COLOR_BOLD_RED "ERROR: Image ends before secret file data" COLOR_RESET); // Print error message
+            return e_failure;                                                           // Return failure
+        }
+        decode_data_block(sec, size, str); // Decode block from LSBs
+        fwrite(sec, 1, size, decInfo->fptr_stego_image); // Write decoded block to output file
+        length -= size;                                  // Move to next block
+    }
+    return e_success; // Return success
+}
+
 Status decode_secret_file_data(DecodeInfo *decInfo)
 {
     printf(COLOR_BOLD_GREEN "INFO: Decoding %s File Data\n" COLOR_RESET, decInfo->stego_image_fname); // Print decoding file data message
-    int i = 0;                                                                                        // Initialize loop variable
-    char str[8];                                                                                      // Buffer to store 8 bits
-    char sec[decInfo->size_secret_file];                                                              // Buffer to store secret file data
     fseek(decInfo->fptr_stego_image, 0, SEEK_SET);                                                    // Move file pointer to start of stego image
-    for (i = 0; i < decInfo->size_secret_file; i++)                                                   // Loop through secret file size
+    if (decInfo->range_spec == NULL)                                                                  // Check if whole file is wanted
     {
-        fread(str, 1, 8, decInfo->fptr_src_image); // Read 8 bits from image
-        decode_byte_tolsb(&sec[i], str);           // Decode byte from LSB
+        return decode_secret_data_range(0, decInfo->size_secret_file, decInfo); // Decode all secret bytes
     }
-    fwrite(sec, 1, decInfo->size_secret_file, decInfo->fptr_stego_image); // Write decoded data to stego image
-    return e_success;                                                     // Return success
+    printf(COLOR_BOLD_GREEN "INFO: Extracting %ld bytes from offset %ld\n" COLOR_RESET, decInfo->range_length, decInfo->range_offset); // Print range message
+    return decode_secret_data_range(decInfo->range_offset, decInfo->range_length, decInfo);                                          // Decode requested range only
 }
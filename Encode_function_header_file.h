@@ -2,6 +2,9 @@
 #define ENCODE_H
 
 #include "Return_types.h" // Include user-defined types from types.h
+#include "Magic_string.h" // Include shared block size
+#include "Palette_function_header_file.h" // Include palette types for 8 bit images
+#include "Matrix_function_header_file.h" // Include matrix embedding functions
 
 /* 
  * Structure to store information required for
@@ -17,6 +20,8 @@
 #define MAX_SECRET_BUF_SIZE 1                     // Maximum buffer size for secret data
 #define MAX_IMAGE_BUF_SIZE (MAX_SECRET_BUF_SIZE * 8) // Maximum buffer size for image data (8 times secret buffer size)
 #define MAX_FILE_SUFFIX 4                         // Maximum length of file suffix (e.g., ".txt")
+#define STAGING_SUFFIX ".part"                    // Suffix of stego image while it is not committed
+#define VERIFY_PIECE_SIZE 256                     // Secret bytes encoded and read back while their image bytes are in L1 cache
 
 typedef struct _EncodeInfo // Structure to hold encoding-related information
 {
@@ -26,6 +31,7 @@ typedef struct _EncodeInfo // Structure to hold encoding-related information
     uint image_capacity;   // Capacity of the image to hold data
     uint bits_per_pixel;   // Bits per pixel in the image
     char image_data[MAX_IMAGE_BUF_SIZE]; // Buffer to hold image data
+    PaletteInfo palette;   // Palette and parity swap table of 8 bit images
 
     /* Secret File Info */
     char *secret_fname; // Pointer to secret file name
@@ -37,6 +43,33 @@ typedef struct _EncodeInfo // Structure to hold encoding-related information
     /* Stego Image Info */
     char *stego_image_fname; // Pointer to stego image file name
     FILE *fptr_stego_image;  // File pointer for stego image
+    char *output_fname;      // Pointer to final stego image name when output is staged
+    char staging_fname[FILENAME_MAX + sizeof(STAGING_SUFFIX)]; // Name stego image is written under until committed
+
+    /* Verification Info */
+    int verify;              // Re-extract every encoded block and compare with source
+    long verify_mismatches;  // Number of bytes that did not read back as encoded
+
+    /* Matrix Embedding Info */
+    uint matrix_rate;        // Secret bits per group of 2^K - 1 image bytes, 0 for plain LSB
+    long matrix_changed;     // Number of image bytes changed by matrix embedding
+
+    /* Quality Metrics Info */
+    int metrics;                 // Measure distortion of the stego image while encoding
+    double max_mse;              // Fail when mean squared error is above, negative when not checked
+    double min_psnr;             // Fail when PSNR in dB is below, negative when not checked
+    int max_delta;               // Fail when a channel moves further, negative when not checked
+    long long metric_sq_error;   // Sum of squared channel differences
+    long metric_changed;         // Number of image bytes changed
+    int metric_max_delta;        // Largest channel difference
+
+    /* Pipeline Info */
+    int pipeline;            // Overlap reading, embedding and writing on separate threads
+
+    /* Cache Info */
+    char *cache_dir;                 // Pointer to cache directory, NULL when caching is off
+    long long cache_max_size;        // Size bound of cache directory in bytes
+    char cache_fname[FILENAME_MAX];  // Cache entry for this job
 
 } EncodeInfo;
 
@@ -59,6 +92,9 @@ Status check_capacity(EncodeInfo *encInfo); // Function to check if the image ha
 /* Get image size */
 uint get_image_size_for_bmp(FILE *fptr_image); // Function to get the size of a BMP image
 
+/* Get offset of pixel data */
+uint get_bmp_pixel_offset(FILE *fptr_image); // Function to get the offset of the BMP pixel array
+
 /* Get file size */
 uint get_file_size(FILE *fptr); // Function to get the size of a file
 
@@ -80,9 +116,25 @@ Status encode_secret_file_size(long file_size, EncodeInfo *encInfo); // Function
 /* Encode secret file data*/
 Status encode_secret_file_data(EncodeInfo *encInfo); // Function to encode the secret file data
 
+/* Encode a block of bytes into LSB of image data */
+void encode_lsb_block(const char *data, long size, char *image_buffer, const PaletteInfo *palInfo); // Encode size bytes into 8 * size image bytes
+
+/* Encode a block of bytes of the secret file */
+Status encode_data_block(EncodeInfo *encInfo, const char *data, long size, char *image_buffer); // Function to encode and optionally verify a block of bytes
+
+/* Commit or discard the stego image */
+Status finish_stego_image(EncodeInfo *encInfo, Status status); // Function to close stego image and commit it only on success
+
 /* Encode function, which does the real encoding */
 Status encode_data_to_image(char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image); // Function to encode data into the image
 
+/* Decode a block of bytes from LSB of image data */
+Status decode_data_block(char *data, long size, const char *image_buffer); // Decoder used to check encoded blocks
+long decode_compare_block(const char *data, long size, const char *image_buffer); // Decoder check of encoded blocks against source
+
+/* Build the header encoded before the secret data */
+void build_stego_header(char *header, const char *extn, long size, uint matrix_rate); // Function to lay out STEGO_HEADER_SIZE header bytes
+
 /* Encode a byte into LSB of image data array */
 Status encode_byte_to_lsb(char data, char *image_buffer); // Function to encode a byte into the least significant bit of the image buffer
 
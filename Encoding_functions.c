@@ -1,24 +1,46 @@
 #include <stdio.h>  // Standard I/O library
 #include "Encode_function_header_file.h" // Header file for encoding functions
+#include "Pipeline_function_header_file.h" // Header file for pipelined encoding
+#include "Cache_function_header_file.h" // Header file for result cache
 #include "Return_types.h"  // Include types header file
 #include "Magic_string.h" // Header file for common utilities
 #include <string.h> // String manipulation functions
+#include <stdlib.h> // abs for channel differences
+#include <math.h>   // log10 for PSNR
 
 /* Function Definitions */
 
 /* Get image size
  * Input: Image file ptr
- * Output: width * height * bytes per pixel (3 in our case)
+ * Output: width * height * bytes per pixel (3 for 24 bit, 1 for 8 bit)
  * Description: In BMP Image, width is stored in offset 18,
- * and height after that. size is 4 bytes
+ * and height after that. size is 4 bytes. Bits per pixel
+ * follow at offset 28
  */
 uint get_image_size_for_bmp(FILE *fptr_image)
 {
     uint width, height;                         // Variables to store width and height
+    unsigned short bpp;                         // Variable to store bits per pixel
     fseek(fptr_image, 18, SEEK_SET);            // Seek to 18th byte in BMP file
     fread(&width, sizeof(int), 1, fptr_image);  // Read width (4 bytes)
     fread(&height, sizeof(int), 1, fptr_image); // Read height (4 bytes)
-    return width * height * 3;                  // Return image size in bytes
+    fseek(fptr_image, 28, SEEK_SET);            // Seek to 28th byte in BMP file
+    fread(&bpp, sizeof(bpp), 1, fptr_image);    // Read bits per pixel (2 bytes)
+    return width * height * (bpp / 8);          // Return image size in bytes
+}
+
+/* Get pixel data offset
+ * Input: Image file ptr
+ * Output: Offset of the first pixel byte from the start of file
+ * Description: In BMP Image, the pixel array offset is stored
+ * at offset 10. size is 4 bytes
+ */
+uint get_bmp_pixel_offset(FILE *fptr_image)
+{
+    uint offset = 0;                            // Variable to store pixel data offset
+    fseek(fptr_image, 10, SEEK_SET);            // Seek to 10th byte in BMP file
+    fread(&offset, sizeof(int), 1, fptr_image); // Read offset (4 bytes)
+    return offset;                              // Return pixel data offset
 }
 
 /*
@@ -93,7 +115,12 @@ Status check_capacity(EncodeInfo *encInfo)
     uint file_ext_size = strlen(ext);                                                                                                      // Get length of file extension
 
     uint total_size = 4 + magic_string_len + 4 + file_ext_size + 4 + encInfo->size_secret_file; // Calculate total size needed
-    if (encInfo->image_capacity < total_size * 8)                                               // Check if image capacity is insufficient
+    long needed = total_size * 8L;                                                              // Image bytes needed
+    if (encInfo->matrix_rate) // Matrix embedding spreads secret data over groups
+    {
+        needed += matrix_cover_size(encInfo->size_secret_file, encInfo->matrix_rate) - encInfo->size_secret_file * 8;
+    }
+    if (encInfo->image_capacity < needed) // Check if image capacity is insufficient
     {
         return e_failure; // Return failure
     }
@@ -104,6 +131,12 @@ Status check_capacity(EncodeInfo *encInfo)
     return e_success; // Return success
 }
 
+/* Check if any distortion threshold was given */
+static int metrics_thresholds_set(const EncodeInfo *encInfo)
+{
+    return encInfo->max_mse >= 0 || encInfo->min_psnr >= 0 || encInfo->max_delta >= 0; // Negative means not checked
+}
+
 Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
 {
     if (!strstr(argv[2], ".bmp")) // Check if source image file is not BMP
@@ -134,6 +167,17 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
         puts(COLOR_BOLD_GREEN "INFO: Output File not mentioned. Creating steged_img.bmp as default" COLOR_RESET); // Log default file creation
         encInfo->stego_image_fname = "steged_img.bmp";                                                            // Set default stego image file name
     }
+    if (encInfo->matrix_rate && encInfo->pipeline) // Pipeline blocks hold 8 image bytes per secret byte
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: --pipeline cannot be used with --matrix" COLOR_RESET); // Log error
+        return e_failure;                                                                                // Return failure
+    }
+    if (encInfo->verify || metrics_thresholds_set(encInfo)) // Check if output has to be checked before it is committed
+    {
+        encInfo->output_fname = encInfo->stego_image_fname;                                                         // Remember final stego image name
+        snprintf(encInfo->staging_fname, sizeof encInfo->staging_fname, "%s" STAGING_SUFFIX, encInfo->output_fname); // Build staging name
+        encInfo->stego_image_fname = encInfo->staging_fname;                                                        // Write stego image under staging name
+    }
     if (open_files(encInfo) == 0) // Open required files
     {
         puts(COLOR_BOLD_GREEN "INFO: Done" COLOR_RESET);                             // Log success
@@ -143,6 +187,11 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
     fread(data, 1, 2, encInfo->fptr_src_image); // Read first 2 bytes of BMP file
     if (data[0] == 0x42 && data[1] == 0x4d)     // Check if BMP signature is valid
     {
+        encInfo->bits_per_pixel = get_bmp_bits_per_pixel(encInfo->fptr_src_image); // Get bits per pixel
+        if (read_bmp_palette(encInfo->fptr_src_image, &encInfo->palette) == e_failure) // Prepare parity swaps for 8 bit images
+        {
+            return e_failure; // Return failure
+        }
         if (check_capacity(encInfo) == e_failure) // Check if image has enough capacity
         {
             return e_failure; // Return failure
@@ -154,22 +203,40 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
     }
 }
 
+/*
+ * Copy bmp image header
+ * Description: Everything before the pixel array is copied, which
+ * includes the colour palette of 8 bit images. The pixel offset comes
+ * from the file, so it is copied in fixed blocks and a file that ends
+ * before its pixel array is rejected
+ */
 Status copy_bmp_header(FILE *src_img, FILE *dest_img)
 {
     puts(COLOR_BOLD_GREEN "INFO: Copying Image Header" COLOR_RESET); // Log message
-    char bmp_header[54];                                             // Buffer to store BMP header
+    uint header_size = get_bmp_pixel_offset(src_img);                // Header and palette end at pixel data
     rewind(src_img);                                                 // Reset source image file pointer
     rewind(dest_img);                                                // Reset destination image file pointer
 
-    if ((fread(bmp_header, 1, 54, src_img)) != 54) // Read BMP header
+    char bmp_header[1024]; // Buffer to store a block of BMP header
+    if (header_size < 54)  // Pixel data cannot start inside the fixed header
     {
-        perror(COLOR_BOLD_SLOW_BLINKING_RED "Failed to read BMP header" COLOR_RESET); // Log error
-        return 1;                                                                     // Return failure
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "Invalid BMP pixel data offset" COLOR_RESET); // Log error
+        return 1;                                                                        // Return failure
     }
-    if (fwrite(bmp_header, 1, 54, dest_img) != 54) // Write BMP header to destination
+    for (uint left = header_size; left > 0;) // Copy header block by block
     {
-        perror(COLOR_BOLD_SLOW_BLINKING_RED "Failed to write BMP header" COLOR_RESET); // Log error
-        return 1;                                                                      // Return failure
+        uint n = left < sizeof bmp_header ? left : sizeof bmp_header; // Bytes in this block
+        if (fread(bmp_header, 1, n, src_img) != n)                    // Read block of BMP header
+        {
+            perror(COLOR_BOLD_SLOW_BLINKING_RED "Failed to read BMP header" COLOR_RESET); // Log error
+            return 1;                                                                     // Return failure
+        }
+        if (fwrite(bmp_header, 1, n, dest_img) != n) // Write block to destination
+        {
+            perror(COLOR_BOLD_SLOW_BLINKING_RED "Failed to write BMP header" COLOR_RESET); // Log error
+            return 1;                                                                      // Return failure
+        }
+        left -= n; // Move to next block
     }
     return 0; // Return success
 }
@@ -208,6 +275,214 @@ Status encode_byte_tolsb(char data, char *image_buffer)
     }
 }
 
+/*
+ * Measure distortion of one changed image byte
+ * Inputs: Original and encoded byte
+ * Description: Palette indices are compared by the colours they stand for.
+ * The caller counts the changed byte, so alpha can be counted unmeasured
+ */
+static void measure_change(EncodeInfo *encInfo, unsigned char before, unsigned char after)
+{
+    int max = encInfo->metric_max_delta; // Largest difference
+    if (encInfo->palette.palettized)     // Pixels are palette indices
+    {
+        for (int c = 0; c < 3; c++) // Compare blue, green and red
+        {
+            int d = abs(encInfo->palette.palette[after][c] - encInfo->palette.palette[before][c]); // Channel difference
+            encInfo->metric_sq_error += d * d;
+            max = d > max ? d : max;
+        }
+    }
+    else
+    {
+        int d = abs(after - before); // Channel difference
+        encInfo->metric_sq_error += d * d;
+        max = d > max ? d : max;
+    }
+    encInfo->metric_max_delta = max; // Keep largest difference
+}
+
+/*
+ * Check if an image byte is the alpha channel of a 32 bit pixel
+ * Input: Offset of the byte from the start of its block
+ * Description: Every block starts a multiple of 4 bytes into the pixel
+ * data, header and LSB blocks use 8 image bytes per secret byte and
+ * matrix blocks hold MATRIX_CHUNK_GROUPS groups, so the offset in the
+ * block gives the channel. Alpha is not shown, so a changed alpha byte
+ * is counted but left out of the distortion
+ */
+static int is_alpha_byte(const EncodeInfo *encInfo, long offset)
+{
+    return encInfo->bits_per_pixel == 32 && (offset & 3) == 3; // Blue, green, red, alpha
+}
+
+/*
+ * Encode a block of bytes into LSBs of image data and measure it
+ * Description: Same result as encode_lsb_block, the distortion of every
+ * image byte is taken from its original value as it is replaced. Setting
+ * a direct colour LSB moves the byte by 0 or 1, so that loop only counts
+ * changed bytes and has no branches, so it is vectorized at -O3
+ */
+static void encode_measured_block(EncodeInfo *encInfo, const char *data, long size, char *image_buffer)
+{
+    unsigned char *img = (unsigned char *)image_buffer; // Image bytes as unsigned
+    if (encInfo->palette.palettized)                    // Palette indices move to the nearest colour with the wanted LSB
+    {
+        for (long i = 0; i < size * 8; i++) // Loop through pixels of block
+        {
+            unsigned char before = img[i];                                                                     // Original index
+            img[i] = encInfo->palette.parity_lut[((unsigned char)data[i >> 3] >> (7 - (i & 7))) & 1][before]; // Index with wanted LSB, MSB first
+            if (img[i] != before)                                                                              // Check if pixel changed
+            {
+                encInfo->metric_changed++;               // Count changed pixel
+                measure_change(encInfo, before, img[i]); // Add distortion of pixel
+            }
+        }
+        return;
+    }
+    unsigned char shown = encInfo->bits_per_pixel == 32 ? 0x77 : 0xFF; // Bit j clear when byte j of 8 is alpha, as in is_alpha_byte
+    long changed = 0, changed_shown = 0;                                // Bytes changed, and those not alpha
+    for (long i = 0; i < size; i++)                                     // Loop through each byte of data
+    {
+        for (int j = 0; j < 8; j++) // Loop through all 8 bits of byte, MSB first
+        {
+            unsigned char before = img[8 * i + j];                                           // Original byte
+            unsigned char after = (before & ~1) | (((unsigned char)data[i] >> (7 - j)) & 1); // Byte with wanted LSB
+            img[8 * i + j] = after;
+            changed += before ^ after;                        // Count byte if it moved
+            changed_shown += (before ^ after) & (shown >> j); // Count shown byte if it moved
+        }
+    }
+    encInfo->metric_changed += changed;        // Alpha bytes are counted too
+    encInfo->metric_sq_error += changed_shown; // Every shown changed byte moved by 1
+    encInfo->metric_max_delta = changed_shown && encInfo->metric_max_delta < 1 ? 1 : encInfo->metric_max_delta;
+}
+
+/*
+ * Encode a block of bytes into LSBs of image data
+ * Input: size bytes of data and 8 * size bytes of image data
+ * Description: Shared by single file, archive and update encoding
+ */
+void encode_lsb_block(const char *data, long size, char *image_buffer, const PaletteInfo *palInfo)
+{
+    if (palInfo->palettized) // Palette indices move to the nearest colour with the wanted LSB
+    {
+        for (long i = 0; i < size; i++) // Loop through each byte of data
+        {
+            encode_byte_to_palette(data[i], image_buffer + 8 * i, palInfo); // Encode byte by table lookup
+        }
+    }
+    else
+    {
+        for (long i = 0; i < size; i++) // Loop through each byte of data
+        {
+            encode_byte_tolsb(data[i], image_buffer + 8 * i); // Encode byte into LSBs
+        }
+    }
+}
+
+/*
+ * Encode a block of bytes of the secret file
+ * Input: size bytes of data and 8 * size bytes of image data
+ * Description: With verification enabled the block is encoded in pieces
+ * of VERIFY_PIECE_SIZE bytes, and each piece is decoded again right after
+ * it is encoded, while its image bytes are still in L1 cache
+ */
+Status encode_data_block(EncodeInfo *encInfo, const char *data, long size, char *image_buffer)
+{
+    long piece = encInfo->verify ? VERIFY_PIECE_SIZE : size; // Bytes encoded before they are read back
+    while (size > 0)                                         // Loop through block piece by piece
+    {
+        long n = size < piece ? size : piece; // Bytes in this piece
+        if (encInfo->metrics)                 // Check if distortion is measured
+        {
+            encode_measured_block(encInfo, data, n, image_buffer); // Encode piece and measure each byte
+        }
+        else
+        {
+            encode_lsb_block(data, n, image_buffer, &encInfo->palette); // Encode piece into LSBs
+        }
+        if (encInfo->verify) // Check if verification is enabled
+        {
+            encInfo->verify_mismatches += decode_compare_block(data, n, image_buffer); // Decode piece and compare
+        }
+        data += n, image_buffer += n * 8, size -= n; // Move to next piece
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Matrix embed a block of bytes into groups of image data
+ * Input: size bytes of data and matrix_cover_size(size, K) bytes of image data
+ */
+static Status encode_matrix_block(EncodeInfo *encInfo, const char *data, long size, char *image_buffer)
+{
+    MatrixChange changes[MATRIX_CHUNK_GROUPS]; // Changed bytes, at most one per group
+    long changed = matrix_embed_block(data, size, image_buffer, encInfo->matrix_rate, &encInfo->palette,
+                                      encInfo->metrics ? changes : NULL); // Embed and record changed bytes when measured
+    encInfo->matrix_changed += changed;                                   // Count changed bytes
+    encInfo->metric_changed += changed;                                   // Alpha bytes are counted too
+    for (long i = 0; i < changed && encInfo->metrics; i++)                // Measure changed bytes from their original values
+    {
+        if (!is_alpha_byte(encInfo, changes[i].offset)) // Alpha has no distortion
+        {
+            measure_change(encInfo, changes[i].original, (unsigned char)image_buffer[changes[i].offset]); // Add distortion of byte
+        }
+    }
+    if (encInfo->verify) // Check if verification is enabled
+    {
+        char check[MATRIX_CHUNK_SIZE(MATRIX_MAX_RATE)];                             // Buffer to store bytes read back
+        matrix_extract_block(check, size, image_buffer, encInfo->matrix_rate); // Extract block again
+        for (long i = 0; i < size; i++)                                          // Compare with source
+        {
+            encInfo->verify_mismatches += check[i] != data[i]; // Count bytes that do not read back
+        }
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Encode secret file data with matrix embedding
+ * Description: Blocks hold whole groups, so every block starts on a
+ * group boundary and only the last group of the file is padded
+ */
+static Status encode_secret_file_data_matrix(EncodeInfo *encInfo)
+{
+    uint k = encInfo->matrix_rate;                                                                        // Secret bits per group
+    char sec[MATRIX_CHUNK_SIZE(MATRIX_MAX_RATE)];                                                         // Buffer to store a chunk of secret file data
+    char str[MATRIX_CHUNK_GROUPS * MATRIX_MAX_GROUP];                                                     // Buffer to store image bytes for that chunk
+    long left = encInfo->size_secret_file;                                                                // Secret bytes still to encode
+    printf(COLOR_BOLD_GREEN "INFO: Matrix embedding %u bits per %u image bytes\n" COLOR_RESET, k, matrix_group_size(k)); // Log message
+    fseek(encInfo->fptr_secret, 0, SEEK_SET);                                                             // Reset secret file pointer
+    encInfo->matrix_changed = 0;                                                                          // Nothing changed yet
+    while (left > 0)                                                                                      // Loop through secret file chunk by chunk
+    {
+        long size = left < MATRIX_CHUNK_SIZE(k) ? left : MATRIX_CHUNK_SIZE(k); // Bytes in this chunk
+        long cover = matrix_cover_size(size, k);                              // Image bytes of its groups
+        if (fread(sec, 1, size, encInfo->fptr_secret) != (size_t)size)        // Read chunk of secret file
+        {
+            return e_failure; // Return failure
+        }
+        if (fread(str, 1, cover, encInfo->fptr_src_image) != (size_t)cover) // Read image bytes of the groups
+        {
+            return e_failure; // Return failure
+        }
+        encode_matrix_block(encInfo, sec, size, str);          // Embed chunk into groups
+        fwrite(str, 1, cover, encInfo->fptr_stego_image);      // Write encoded bytes to stego image
+        left -= size;                                          // Move to next chunk
+    }
+    printf(COLOR_BOLD_GREEN "INFO: Changed %ld of %ld image bytes\n" COLOR_RESET, encInfo->matrix_changed,
+           matrix_cover_size(encInfo->size_secret_file, k)); // Log changed bytes
+    return e_success;                                       // Return success
+}
+
+/* Encode a 32 bit integer, MSB first, into 32 bytes of image data */
+static Status encode_int_block(EncodeInfo *encInfo, long value, char *image_buffer)
+{
+    char bytes[4] = {value >> 24, value >> 16, value >> 8, value}; // Split integer into bytes, MSB first
+    return encode_data_block(encInfo, bytes, 4, image_buffer);     // Same bit layout as encode_int_tolsb
+}
+
 Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo)
 {
     puts(COLOR_BOLD_GREEN "INFO: Encoding Magic String Signature" COLOR_RESET); // Log message
@@ -216,20 +491,24 @@ Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo)
     int lem = strlen(magic_string);                                             // Get length of magic string
     for (i = 0; i < lem; i++)                                                   // Loop through each character of magic string
     {
-        if (fread(str, 1, 8, encInfo->fptr_src_image) == 8) // Read 8 bytes from source image
+        if (fread(str, 1, 8, encInfo->fptr_src_image) != 8) // Read 8 bytes from source image
         {
-            encode_byte_tolsb(magic_string[i], str); // Encode character into LSBs
+            return e_failure; // Return failure
         }
-        fwrite(str, 1, 8, encInfo->fptr_stego_image); // Write encoded bytes to stego image
+        encode_data_block(encInfo, &magic_string[i], 1, str); // Encode character into LSBs
+        fwrite(str, 1, 8, encInfo->fptr_stego_image);         // Write encoded bytes to stego image
     }
     return e_success; // Return success
 }
 
 Status encode_secret_file_extn_size(long int size, EncodeInfo *encInfo)
 {
-    char str1[32];                                  // Buffer to store 32 bytes
-    fread(str1, 1, 32, encInfo->fptr_src_image);    // Read 32 bytes from source image
-    encode_int_tolsb(size, str1);                   // Encode size into LSBs
+    char str1[32];                                        // Buffer to store 32 bytes
+    if (fread(str1, 1, 32, encInfo->fptr_src_image) != 32) // Read 32 bytes from source image
+    {
+        return e_failure; // Return failure
+    }
+    encode_int_block(encInfo, size, str1);          // Encode size into LSBs
     fwrite(str1, 1, 32, encInfo->fptr_stego_image); // Write encoded bytes to stego image
     return e_success;                               // Return success
 }
@@ -237,23 +516,25 @@ Status encode_secret_file_extn_size(long int size, EncodeInfo *encInfo)
 Status encode_secret_file_extn(const char *ext, EncodeInfo *encInfo)
 {
     printf(COLOR_BOLD_GREEN "INFO: Encoding %s File Extension\n" COLOR_RESET, encInfo->secret_fname); // Log message
-    int i = 0;                                                                                        // Initialize index
-    char str[8];                                                                                      // Buffer to store 8 bytes
-    for (i = 0; i < 3; i++)                                                                           // Loop through first 3 characters of extension
+    char str[24];                                                                                     // Buffer to store 24 bytes
+    if (fread(str, 1, 24, encInfo->fptr_src_image) != 24)                                             // Read 24 bytes from source image
     {
-        fread(str, 1, 8, encInfo->fptr_src_image);    // Read 8 bytes from source image
-        encode_byte_tolsb(ext[i], str);               // Encode character into LSBs
-        fwrite(str, 1, 8, encInfo->fptr_stego_image); // Write encoded bytes to stego image
+        return e_failure; // Return failure
     }
-    return e_success; // Return success
+    encode_data_block(encInfo, ext, 3, str);                                                          // Encode first 3 characters of extension
+    fwrite(str, 1, 24, encInfo->fptr_stego_image);                                                    // Write encoded bytes to stego image
+    return e_success;                                                                                 // Return success
 }
 
 Status encode_secret_file_size(long file_size, EncodeInfo *encInfo)
 {
     printf(COLOR_BOLD_GREEN "INFO: Encoding %s File Size\n" COLOR_RESET, encInfo->secret_fname); // Log message
     char str1[32];                                                                               // Buffer to store 32 bytes
-    fread(str1, 1, 32, encInfo->fptr_src_image);                                                 // Read 32 bytes from source image
-    encode_int_tolsb(file_size, str1);                                                           // Encode file size into LSBs
+    if (fread(str1, 1, 32, encInfo->fptr_src_image) != 32)                                       // Read 32 bytes from source image
+    {
+        return e_failure; // Return failure
+    }
+    encode_int_block(encInfo, file_size, str1);                                                  // Encode file size into LSBs
     fwrite(str1, 1, 32, encInfo->fptr_stego_image);                                              // Write encoded bytes to stego image
     return e_success;                                                                            // Return success
 }
@@ -261,16 +542,28 @@ Status encode_secret_file_size(long file_size, EncodeInfo *encInfo)
 Status encode_secret_file_data(EncodeInfo *encInfo)
 {
     printf(COLOR_BOLD_GREEN "INFO: Encoding %s File Data\n" COLOR_RESET, encInfo->secret_fname); // Log message
-    int i = 0;                                                                                   // Initialize index
-    char str[8];                                                                                 // Buffer to store 8 bytes
-    char sec[encInfo->size_secret_file];                                                         // Buffer to store secret file data
+    if (encInfo->matrix_rate) // Check if matrix embedding is selected
+    {
+        return encode_secret_file_data_matrix(encInfo); // Embed data in groups
+    }
+    char sec[MAX_DATA_CHUNK_SIZE];                                                               // Buffer to store a chunk of secret file data
+    char str[MAX_DATA_CHUNK_SIZE * 8];                                                           // Buffer to store image bytes for that chunk
+    long left = encInfo->size_secret_file;                                                       // Secret bytes still to encode
     fseek(encInfo->fptr_secret, 0, SEEK_SET);                                                    // Reset secret file pointer
-    fread(sec, 1, encInfo->size_secret_file, encInfo->fptr_secret);                              // Read secret file data
-    for (i = 0; i < encInfo->size_secret_file; i++)                                              // Loop through each byte of secret file
+    while (left > 0)                                                                             // Loop through secret file chunk by chunk
     {
-        fread(str, 1, 8, encInfo->fptr_src_image);    // Read 8 bytes from source image
-        encode_byte_tolsb(sec[i], str);               // Encode byte into LSBs
-        fwrite(str, 1, 8, encInfo->fptr_stego_image); // Write encoded bytes to stego image
+        long size = left < MAX_DATA_CHUNK_SIZE ? left : MAX_DATA_CHUNK_SIZE; // Bytes in this chunk
+        if (fread(sec, 1, size, encInfo->fptr_secret) != (size_t)size)      // Read chunk of secret file
+        {
+            return e_failure; // Return failure
+        }
+        if (fread(str, 1, size * 8, encInfo->fptr_src_image) != (size_t)size * 8) // Read 8 bytes from source image per secret byte
+        {
+            return e_failure; // Return failure
+        }
+        encode_data_block(encInfo, sec, size, str);         // Encode chunk into LSBs
+        fwrite(str, 1, size * 8, encInfo->fptr_stego_image); // Write encoded bytes to stego image
+        left -= size;                                        // Move to next chunk
     }
     return e_success; // Return success
 }
@@ -278,15 +571,108 @@ Status encode_secret_file_data(EncodeInfo *encInfo)
 Status copy_remaining_img_data(FILE *src, FILE *dest)
 {
     puts(COLOR_BOLD_GREEN "INFO: Copying Left Over Data" COLOR_RESET); // Log message
-    char ch;                                                           // Variable to store a byte
-    while (fread(&ch, 1, 1, src) > 0)                                  // Read remaining bytes from source image
+    char buffer[MAX_DATA_CHUNK_SIZE * 8];                              // Buffer to store a block of bytes
+    size_t n;                                                          // Bytes read in this block
+    while ((n = fread(buffer, 1, sizeof buffer, src)) > 0)             // Read remaining bytes from source image
     {
-        fwrite(&ch, 1, 1, dest); // Write bytes to destination image
+        if (fwrite(buffer, 1, n, dest) != n) // Write bytes to destination image
+        {
+            return e_failure; // Return failure
+        }
     }
     return e_success; // Return success
 }
 
-Status do_encoding(EncodeInfo *encInfo)
+/*
+ * Commit or discard the stego image
+ * Description: A staged stego image is renamed to its final name only
+ * when encoding succeeded, otherwise it is removed
+ */
+Status finish_stego_image(EncodeInfo *encInfo, Status status)
+{
+    if (fclose(encInfo->fptr_stego_image) != 0) // Flush and close stego image
+    {
+        perror("fclose");   // Print error message
+        status = e_failure; // Unflushed output is a failure
+    }
+    encInfo->fptr_stego_image = NULL; // Stego image is closed
+    if (encInfo->output_fname == NULL) // Check if output was written in place
+    {
+        return status; // Nothing to commit
+    }
+    if (status != e_success) // Discard staged output on failure
+    {
+        remove(encInfo->stego_image_fname);                                                           // Remove staged stego image
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %s not written\n" COLOR_RESET, encInfo->output_fname); // Log error
+        return status;                                                                                // Return failure
+    }
+    if (rename(encInfo->stego_image_fname, encInfo->output_fname) != 0) // Commit staged stego image
+    {
+        perror("rename");                   // Print error message
+        remove(encInfo->stego_image_fname); // Remove staged stego image
+        return e_failure;                   // Return failure
+    }
+    encInfo->stego_image_fname = encInfo->output_fname; // Stego image now lives under its final name
+    return e_success;                                   // Return success
+}
+
+/*
+ * Build the header as it is encoded at the start of the pixel data
+ * Inputs: Extension, at least 3 bytes like extn_secret_file, secret file
+ * size and matrix rate, 0 for plain LSB
+ * Output: STEGO_HEADER_SIZE bytes: magic string, extension size with the
+ * embedding mode, first 3 characters of extension and file size, MSB first
+ */
+void build_stego_header(char *header, const char *extn, long size, uint matrix_rate)
+{
+    uint magic_len = strlen(MAGIC_STRING);                                                // Length of magic string
+    long ext = strlen(extn) | (long)matrix_rate << EMBED_MODE_SHIFT;                      // Extension size and embedding mode
+    char *field = header + magic_len;                                                     // Fields after magic string
+    memcpy(header, MAGIC_STRING, magic_len);                                              // Magic string
+    field[0] = ext >> 24, field[1] = ext >> 16, field[2] = ext >> 8, field[3] = ext;      // Extension size, MSB first
+    memcpy(field + 4, extn, 3);                                                           // First 3 characters of extension
+    field[7] = size >> 24, field[8] = size >> 16, field[9] = size >> 8, field[10] = size; // File size, MSB first
+}
+
+/*
+ * Read the encoded header back from the stego image
+ * Description: The magic string, extension size, extension and file size
+ * are decoded from the written file and compared with what was encoded
+ * Return Value: Number of header bytes that did not read back
+ */
+static long verify_stego_header(EncodeInfo *encInfo)
+{
+    char expected[STEGO_HEADER_SIZE];                                                                       // Header as it was encoded
+    char str[sizeof expected * 8];                                                                          // Image bytes holding the header
+    build_stego_header(expected, encInfo->extn_secret_file, encInfo->size_secret_file, encInfo->matrix_rate); // Build header again
+
+    FILE *fptr = fopen(encInfo->stego_image_fname, "r"); // Separate handle on the written stego image
+    if (fflush(encInfo->fptr_stego_image) != 0 || fptr == NULL)
+    {
+        if (fptr != NULL)
+        {
+            fclose(fptr);
+        }
+        return sizeof expected; // Nothing could be read back
+    }
+    fseek(fptr, get_bmp_pixel_offset(fptr), SEEK_SET);   // Header starts at pixel data
+    size_t n = fread(str, 1, sizeof str, fptr);          // Read header blocks
+    fclose(fptr);
+    if (n != sizeof str)
+    {
+        return sizeof expected; // Header is missing
+    }
+    char header[sizeof expected];                   // Header as the decoder reads it
+    long mismatches = 0;                            // Header bytes that differ
+    decode_data_block(header, sizeof header, str);  // Decode header bytes
+    for (size_t i = 0; i < sizeof expected; i++)    // Compare with encoded header
+    {
+        mismatches += header[i] != expected[i];
+    }
+    return mismatches; // Return number of mismatches
+}
+
+static Status encode_stego_image(EncodeInfo *encInfo)
 {
     if (copy_bmp_header(encInfo->fptr_src_image, encInfo->fptr_stego_image) == 0) // Copy BMP header
     {
@@ -294,7 +680,7 @@ Status do_encoding(EncodeInfo *encInfo)
         if (encode_magic_string(MAGIC_STRING, encInfo) == 0) // Encode magic string
         {
             puts(COLOR_BOLD_GREEN "INFO: Done" COLOR_RESET);                                   // Log success
-            if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file), encInfo) == 0) // Encode file extension size
+            if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file) | (long)encInfo->matrix_rate << EMBED_MODE_SHIFT, encInfo) == 0) // Encode file extension size and embedding mode
             {
                 if (encode_secret_file_extn(encInfo->extn_secret_file, encInfo) == 0) // Encode file extension
                 {
@@ -302,13 +688,13 @@ Status do_encoding(EncodeInfo *encInfo)
                     if (encode_secret_file_size(encInfo->size_secret_file, encInfo) == 0) // Encode file size
                     {
                         puts(COLOR_BOLD_GREEN "INFO: Done" COLOR_RESET); // Log success
-                        if (encode_secret_file_data(encInfo) == 0)       // Encode file data
+                        if ((encInfo->pipeline ? encode_pipelined(encInfo) : encode_secret_file_data(encInfo)) == 0) // Encode file data
                         {
                             puts(COLOR_BOLD_GREEN "INFO: Done" COLOR_RESET);                                      // Log success
-                            if (copy_remaining_img_data(encInfo->fptr_src_image, encInfo->fptr_stego_image) == 0) // Copy remaining image data
+                            if (encInfo->pipeline || copy_remaining_img_data(encInfo->fptr_src_image, encInfo->fptr_stego_image) == 0) // Copy remaining image data, pipeline already did
                             {
-                                puts(COLOR_BOLD_GREEN "INFO: Done\033[0m");                                  // Log success
-                                puts(COLOR_BOLD_GREEN "INFO: ## Encoding Done Successfully ##" COLOR_RESET); // Log completion
+                                puts(COLOR_BOLD_GREEN "INFO: Done\033[0m"); // Log success
+                                return e_success;                           // Return success
                             }
                             else
                             {
@@ -352,3 +738,95 @@ Status do_encoding(EncodeInfo *encInfo)
         return e_failure;                                          // Return failure
     }
 }
+
+/*
+ * Report quality metrics and check thresholds
+ * Description: MSE is taken over every colour sample of the image,
+ * so it does not depend on how much of the image the secret file uses.
+ * Alpha bytes of 32 bit pixels are not colour samples
+ * Return Value: e_failure when the stego image is over a threshold
+ */
+static Status report_quality_metrics(EncodeInfo *encInfo)
+{
+    double samples = encInfo->image_capacity; // Colour samples in image
+    if (encInfo->palette.palettized)          // Every index stands for blue, green and red
+    {
+        samples *= 3;
+    }
+    else if (encInfo->bits_per_pixel == 32) // Leave alpha out
+    {
+        samples = samples / 4 * 3;
+    }
+    double mse = encInfo->metric_sq_error / samples;                                          // Mean squared error
+    double psnr = mse > 0 ? 10 * log10(255.0 * 255.0 / mse) : INFINITY;                      // Peak signal to noise ratio
+    printf(COLOR_BOLD_GREEN "INFO: MSE %.6f, PSNR %.2f dB, max channel delta %d, %ld bytes changed\n" COLOR_RESET,
+           mse, psnr, encInfo->metric_max_delta, encInfo->metric_changed); // Log metrics
+    Status status = e_success;                                             // Assume within budget
+    if (encInfo->max_mse >= 0 && mse > encInfo->max_mse)                   // Check MSE budget
+    {
+        printf("\033[0;31mERROR: MSE %.6f is above %.6f\033[0m\n", mse, encInfo->max_mse); // Log error
+        status = e_failure;                                                                // Fail before committing output
+    }
+    if (encInfo->min_psnr >= 0 && psnr < encInfo->min_psnr) // Check PSNR budget
+    {
+        printf("\033[0;31mERROR: PSNR %.2f dB is below %.2f dB\033[0m\n", psnr, encInfo->min_psnr); // Log error
+        status = e_failure;                                                                        // Fail before committing output
+    }
+    if (encInfo->max_delta >= 0 && encInfo->metric_max_delta > encInfo->max_delta) // Check channel delta budget
+    {
+        printf("\033[0;31mERROR: Max channel delta %d is above %d\033[0m\n", encInfo->metric_max_delta, encInfo->max_delta); // Log error
+        status = e_failure;                                                                                                // Fail before committing output
+    }
+    return status; // Return result of checks
+}
+
+Status do_encoding(EncodeInfo *encInfo)
+{
+    if (encInfo->cache_dir != NULL && (encInfo->metrics || encInfo->verify)) // Metrics and verification happen while encoding, a cached image has neither
+    {
+        printf(COLOR_BOLD_GREEN "INFO: Cache not used, %s while encoding\n" COLOR_RESET, encInfo->verify ? "blocks are verified" : "metrics are measured"); // Log message
+        encInfo->cache_dir = NULL;                                                                                                                      // Always encode
+    }
+    if (encInfo->cache_dir != NULL && cache_compute_key(encInfo) == e_success) // Check if this job was encoded before
+    {
+        int hit = cache_lookup(encInfo) == e_success; // Copy cached stego image on a hit
+        cache_update_stats(encInfo, hit);             // Count hit or miss
+        if (hit)
+        {
+            puts(COLOR_BOLD_GREEN "INFO: ## Encoding Done Successfully ##" COLOR_RESET); // Log completion
+            return e_success;                                                           // Return success
+        }
+    }
+    encInfo->verify_mismatches = 0;          // Nothing verified yet
+    encInfo->metric_sq_error = 0;            // Nothing measured yet
+    encInfo->metric_changed = 0;
+    encInfo->metric_max_delta = 0;
+    Status status = encode_stego_image(encInfo); // Encode secret file into stego image
+    if (status == e_success && encInfo->verify) // Check encoded blocks read back as the source
+    {
+        encInfo->verify_mismatches += verify_stego_header(encInfo); // Header is read back from the written file
+        if (encInfo->verify_mismatches != 0)
+        {
+            printf("\033[0;31mERROR: Verification failed, %ld bytes did not read back\033[0m\n", encInfo->verify_mismatches); // Log error
+            status = e_failure;                                                                                                 // Fail before committing output
+        }
+        else
+        {
+            puts(COLOR_BOLD_GREEN "INFO: Verified header and secret file data" COLOR_RESET); // Log success
+        }
+    }
+    if (status == e_success && encInfo->metrics) // Check stego image stays within distortion budget
+    {
+        status = report_quality_metrics(encInfo);
+    }
+    if (finish_stego_image(encInfo, status) != e_success) // Commit stego image only on success
+    {
+        return e_failure; // Return failure
+    }
+    if (encInfo->cache_dir != NULL) // Keep result for identical jobs
+    {
+        cache_store(encInfo);
+    }
+    puts(COLOR_BOLD_GREEN "INFO: ## Encoding Done Successfully ##" COLOR_RESET); // Log completion
+    return e_success;                                                           // Return success
+}
@@ -4,4 +4,17 @@
 /* Magic string to identify whether stegged or not */
 #define MAGIC_STRING "#*" // Define a magic string used for steganography identification
 
+/* Magic string to identify a multi-file archive payload */
+#define ARCHIVE_MAGIC_STRING "#&" // Define a magic string used for archive identification
+
+/* Bit of extension size field where the embedding mode starts */
+#define EMBED_MODE_SHIFT 16 // Define shift of matrix rate in extension size field, 0 means plain LSB
+#define EMBED_MODE_MASK 0xFF // Define mask of matrix rate after shifting
+
+/* Bytes of the header encoded before the secret data */
+#define STEGO_HEADER_SIZE (sizeof(MAGIC_STRING) - 1 + 4 + 3 + 4) // Define header bytes: magic string, extension size, extension and file size
+
+/* Secret bytes handled per image block, image blocks are 8 times larger */
+#define MAX_DATA_CHUNK_SIZE 4096 // Define secret bytes encoded, decoded or compared per image block
+
 #endif // End of include guard
@@ -1,8 +1,14 @@
 #include <stdio.h>  // Include standard input-output header
 #include "Encode_function_header_file.h" // Include header file for encoding functions
 #include "Decode_function_header_file.h" // Include header file for decoding functions
+#include "Analyze_function_header_file.h" // Include header file for analysis functions
+#include "Archive_function_header_file.h" // Include header file for archive functions
+#include "Update_function_header_file.h" // Include header file for update functions
+#include "Cache_function_header_file.h" // Include header file for result cache
 #include "Return_types.h"  // Include header file for custom types
 #include <string.h> // Include string manipulation functions
+#include <stdlib.h> // Include strtol and strtod for numeric options
+#include <limits.h> // Include LONG_MAX to bound the cache size
 
 // Define color codes for terminal output
 #define COLOR_BOLD_SLOW_BLINKING "\e[1;5m"        // Bold slow blinking text
@@ -10,19 +16,147 @@
 #define COLOR_BOLD_BLUE "\e[1;34m"                // Bold blue text
 #define COLOR_RESET "\e[0m"                       // Reset text formatting
 
+/*
+ * Remove a flag from argv
+ * Description: Later arguments are shifted down so the positional
+ * arguments keep their places and argv stays NULL terminated
+ * Return Value: 1 if the flag was present, 0 otherwise
+ */
+static int take_flag(int *argc, char *argv[], const char *flag)
+{
+    for (int i = 2; i < *argc; i++) // Options come after the operation
+    {
+        if (!strcmp(argv[i], flag)) // Check if this is the flag
+        {
+            memmove(&argv[i], &argv[i + 1], (*argc - i) * sizeof(char *)); // Shift remaining arguments and NULL down
+            (*argc)--;                                                     // One argument less
+            return 1;                                                      // Flag found
+        }
+    }
+    return 0; // Flag not found
+}
+
+/*
+ * Remove an option and its value from argv
+ * Return Value: The option value, or NULL if the option was not present
+ */
+static char *take_option(int *argc, char *argv[], const char *option)
+{
+    for (int i = 2; i + 1 < *argc; i++) // Options come after the operation
+    {
+        if (!strcmp(argv[i], option)) // Check if this is the option
+        {
+            char *value = argv[i + 1];                                          // Option value follows the option
+            memmove(&argv[i], &argv[i + 2], (*argc - i - 1) * sizeof(char *)); // Shift remaining arguments and NULL down
+            *argc -= 2;                                                         // Two arguments less
+            return value;                                                       // Return option value
+        }
+    }
+    return NULL; // Option not found
+}
+
+/*
+ * Parse a whole number option
+ * Description: The whole value has to be a number, trailing
+ * characters and values outside min..max are rejected
+ * Return Value: 1 if the value is valid, 0 otherwise
+ */
+static int parse_long_option(const char *option, const char *value, long min, long max, long *number)
+{
+    char *end;                          // Pointer to end of parsed number
+    *number = strtol(value, &end, 10); // Parse number
+    if (end == value || *end != '\0' || *number < min || *number > max) // Check for a whole number in range
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %s must be a number between %ld and %ld\n" COLOR_RESET, option, min, max); // Log error
+        return 0;                                                                                                            // Invalid value
+    }
+    return 1; // Valid value
+}
+
+/*
+ * Parse a non-negative decimal option
+ * Return Value: 1 if the whole value is a number of at least 0, 0 otherwise
+ */
+static int parse_double_option(const char *option, const char *value, double *number)
+{
+    char *end;                     // Pointer to end of parsed number
+    *number = strtod(value, &end); // Parse number
+    if (end == value || *end != '\0' || !(*number >= 0)) // Check for a whole number of at least 0, NaN fails the comparison
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %s must be a number of at least 0\n" COLOR_RESET, option); // Log error
+        return 0;                                                                                          // Invalid value
+    }
+    return 1; // Valid value
+}
+
 int main(int argc, char *argv[]) // Main function with command-line arguments
 {
-    EncodeInfo encInfo; // Structure to hold encoding information
-    DecodeInfo decInfo; // Structure to hold decoding information
+    EncodeInfo encInfo = {0}; // Structure to hold encoding information
+    DecodeInfo decInfo = {0}; // Structure to hold decoding information
+    AnalyzeInfo anaInfo; // Structure to hold analysis information
+    ArchiveInfo arcInfo = {0}; // Structure to hold archive information
+    UpdateInfo updInfo = {0};  // Structure to hold update information
+    int archive = 0;           // Pack several files as an archive
+    const char *encode_only = NULL; // First given option that archives do not honour
+
+    if (argc >= 2 && !strcmp(argv[1], "-e")) // Take encoding options out of the positional arguments
+    {
+        encInfo.verify = take_flag(&argc, argv, "--verify"); // Verify stego image before committing it
+        archive = take_flag(&argc, argv, "--archive");       // Pack several files with a table of contents
+        encInfo.pipeline = take_flag(&argc, argv, "--pipeline"); // Overlap reading, embedding and writing
+        encInfo.cache_dir = take_option(&argc, argv, "--cache");   // Reuse results of identical jobs
+        char *cache_size = take_option(&argc, argv, "--cache-size"); // Size bound of cache in MB
+        long cache_mb = CACHE_DEFAULT_SIZE_MB; // Size bound of cache in MB
+        if (cache_size != NULL && !parse_long_option("--cache-size", cache_size, 1, LONG_MAX >> 20, &cache_mb)) // Check size bound
+        {
+            return e_failure; // Return failure
+        }
+        encInfo.cache_max_size = cache_mb * 1024LL * 1024; // Size bound in bytes
+        char *matrix = take_option(&argc, argv, "--matrix");         // Hamming code rate for matrix embedding
+        long rate = 0;                                               // Plain LSB replacement by default
+        if (matrix != NULL && !parse_long_option("--matrix", matrix, MATRIX_MIN_RATE, MATRIX_MAX_RATE, &rate)) // Check matrix rate
+        {
+            return e_failure; // Return failure
+        }
+        encInfo.matrix_rate = rate; // Set matrix rate
+        encInfo.metrics = take_flag(&argc, argv, "--metrics");       // Measure distortion while encoding
+        char *max_mse = take_option(&argc, argv, "--max-mse");       // Largest allowed mean squared error
+        char *min_psnr = take_option(&argc, argv, "--min-psnr");     // Smallest allowed PSNR in dB
+        char *max_delta = take_option(&argc, argv, "--max-delta");   // Largest allowed channel difference
+        long delta = -1;                                             // Negative means not checked
+        encInfo.max_mse = encInfo.min_psnr = -1;
+        if ((max_mse != NULL && !parse_double_option("--max-mse", max_mse, &encInfo.max_mse)) || // Check thresholds
+            (min_psnr != NULL && !parse_double_option("--min-psnr", min_psnr, &encInfo.min_psnr)) ||
+            (max_delta != NULL && !parse_long_option("--max-delta", max_delta, 0, 255, &delta)))
+        {
+            return e_failure; // Return failure
+        }
+        encInfo.max_delta = delta; // Set largest allowed channel difference
+        encInfo.metrics |= max_mse || min_psnr || max_delta;         // Thresholds need metrics
+        encode_only = encInfo.verify ? "--verify" : encInfo.pipeline ? "--pipeline" : encInfo.cache_dir ? "--cache" : cache_size ? "--cache-size" :
+                      matrix ? "--matrix" : max_mse ? "--max-mse" : min_psnr ? "--min-psnr" : max_delta ? "--max-delta" : encInfo.metrics ? "--metrics" : NULL;
+    }
+    else if (argc >= 2 && !strcmp(argv[1], "-d")) // Take decoding options out of the positional arguments
+    {
+        decInfo.range_spec = take_option(&argc, argv, "--range"); // Extract only a range of the secret file
+        arcInfo.list = take_flag(&argc, argv, "--list");            // List archive table of contents
+        arcInfo.extract_name = take_option(&argc, argv, "--extract"); // Extract one archive entry
+    }
 
     if (argc == 1) // Check if no arguments are provided
     {
         // Print help message for encoding and decoding
         printf("Help : \n");
         printf("For Encoding : \n");
-        printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> \n");
+        printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> <optional - --verify> <optional - --pipeline> <optional - --cache DIR> <optional - --cache-size MB> <optional - --matrix K> <optional - --metrics> <optional - --max-mse X> <optional - --min-psnr DB> <optional - --max-delta N> \n");
+        printf(COLOR_BOLD_BLUE "-e --archive" COLOR_RESET " <inputfile.bmp> <outputfile.bmp> <file>...\n");
         printf("For Decoding : \n");
-        printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt>\n");
+        printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt> <optional - --range OFFSET:LENGTH>\n");
+        printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> --list | --extract NAME <optional - outputfile>\n");
+        printf("For Updating : \n");
+        printf(COLOR_BOLD_BLUE "-u" COLOR_RESET " <stegofile.bmp> <secretfile.txt>\n");
+        printf("For Analysis : \n");
+        printf(COLOR_BOLD_BLUE "-a" COLOR_RESET " <optional - --csv | --json> <optional - --threads N> <optional - --output report> <image.bmp>...\n");
         return e_unsupported; // Return unsupported operation
     }
     else if (argc == 2) // Check if only one argument is provided
@@ -32,38 +166,96 @@ int main(int argc, char *argv[]) // Main function with command-line arguments
             // Print help message for encoding
             printf("Help : \n");
             printf("For Encoding : \n");
-            printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> \n");
+            printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> <optional - --verify> <optional - --pipeline> <optional - --cache DIR> <optional - --cache-size MB> <optional - --matrix K> <optional - --metrics> <optional - --max-mse X> <optional - --min-psnr DB> <optional - --max-delta N> \n");
+            printf(COLOR_BOLD_BLUE "-e --archive" COLOR_RESET " <inputfile.bmp> <outputfile.bmp> <file>...\n");
         }
         else if (!strcmp(argv[1], "-d")) // Check if the argument is "-d"
         {
             // Print help message for decoding
             printf("For Decoding : \n");
-            printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt>\n");
+            printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt> <optional - --range OFFSET:LENGTH>\n");
+            printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> --list | --extract NAME <optional - outputfile>\n");
+        }
+        else if (!strcmp(argv[1], "-u")) // Check if the argument is "-u"
+        {
+            // Print help message for updating
+            printf("For Updating : \n");
+            printf(COLOR_BOLD_BLUE "-u" COLOR_RESET " <stegofile.bmp> <secretfile.txt>\n");
+        }
+        else if (!strcmp(argv[1], "-a")) // Check if the argument is "-a"
+        {
+            // Print help message for analysis
+            printf("For Analysis : \n");
+            printf(COLOR_BOLD_BLUE "-a" COLOR_RESET " <optional - --csv | --json> <optional - --threads N> <optional - --output report> <image.bmp>...\n");
         }
         else // Handle invalid arguments
         {
             // Print general help message
             printf("Help : \n");
             printf("For Encoding : \n");
-            printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> \n");
+            printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> <optional - --verify> <optional - --pipeline> <optional - --cache DIR> <optional - --cache-size MB> <optional - --matrix K> <optional - --metrics> <optional - --max-mse X> <optional - --min-psnr DB> <optional - --max-delta N> \n");
+            printf(COLOR_BOLD_BLUE "-e --archive" COLOR_RESET " <inputfile.bmp> <outputfile.bmp> <file>...\n");
             printf("For Decoding : \n");
-            printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt>\n");
+            printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt> <optional - --range OFFSET:LENGTH>\n");
+            printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> --list | --extract NAME <optional - outputfile>\n");
+            printf("For Updating : \n");
+            printf(COLOR_BOLD_BLUE "-u" COLOR_RESET " <stegofile.bmp> <secretfile.txt>\n");
+            printf("For Analysis : \n");
+            printf(COLOR_BOLD_BLUE "-a" COLOR_RESET " <optional - --csv | --json> <optional - --threads N> <optional - --output report> <image.bmp>...\n");
         }
         return e_unsupported; // Return unsupported operation
     }
     else if (argc >= 3) // Check if at least two arguments are provided
     {
-        if (!strcmp(argv[1], "-e")) // Check if the first argument is "-e"
+        if (!strcmp(argv[1], "-e") && archive) // Check if several files are packed as an archive
+        {
+            if (encode_only != NULL) // Archives are packed without verification, pipeline, cache, matrix or metrics
+            {
+                printf(COLOR_BOLD_SLOW_BLINKING_RED "%s is not supported with --archive\n" COLOR_RESET, encode_only);
+                return e_failure; // Return failure
+            }
+            // Validate archive arguments and pack files
+            if (read_and_validate_archive_encode_args(argc, argv, &arcInfo) == e_success)
+            {
+                return do_archive_encoding(&arcInfo); // Perform archive encoding
+            }
+            else // Handle validation failure
+            {
+                printf(COLOR_BOLD_SLOW_BLINKING_RED "Archive read and validate failed\n" COLOR_RESET);
+                return e_failure; // Return failure
+            }
+        }
+        else if (!strcmp(argv[1], "-d") && (arcInfo.list || arcInfo.extract_name != NULL)) // Check if an archive is listed or extracted
+        {
+            // Validate archive arguments and list or extract
+            if (read_and_validate_archive_decode_args(argc, argv, &arcInfo) == e_success)
+            {
+                return arcInfo.list ? do_archive_listing(&arcInfo) : do_archive_extraction(&arcInfo); // Perform listing or extraction
+            }
+            else // Handle validation failure
+            {
+                printf(COLOR_BOLD_SLOW_BLINKING_RED "Archive read and validate failed\n" COLOR_RESET);
+                return e_failure; // Return failure
+            }
+        }
+        else if (!strcmp(argv[1], "-e")) // Check if the first argument is "-e"
         {
             if (argc >= 4) // Check if sufficient arguments are provided for encoding
             {
                 // Validate encoding arguments and perform encoding
                 if (read_and_validate_encode_args(argv, &encInfo) == e_success)
                 {
-                    do_encoding(&encInfo); // Perform encoding
+                    if (do_encoding(&encInfo) != e_success) // Perform encoding
+                    {
+                        return e_failure; // Return failure
+                    }
                 }
                 else // Handle validation failure
                 {
+                    if (encInfo.fptr_stego_image != NULL) // Discard stego image that was already opened
+                    {
+                        finish_stego_image(&encInfo, e_failure);
+                    }
                     printf(COLOR_BOLD_SLOW_BLINKING_RED "Encode read and validate failed\n" COLOR_RESET);
                     return e_failure; // Return failure
                 }
@@ -73,7 +265,8 @@ int main(int argc, char *argv[]) // Main function with command-line arguments
                 // Print help message for encoding
                 printf("Help : \n");
                 printf("For Encoding : \n");
-                printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> \n");
+                printf(COLOR_BOLD_BLUE "-e" COLOR_RESET " <inputfile.bmp> <secretfile.txt> <optional - outputfile.bmp> <optional - --verify> <optional - --pipeline> <optional - --cache DIR> <optional - --cache-size MB> <optional - --matrix K> <optional - --metrics> <optional - --max-mse X> <optional - --min-psnr DB> <optional - --max-delta N> \n");
+                printf(COLOR_BOLD_BLUE "-e --archive" COLOR_RESET " <inputfile.bmp> <outputfile.bmp> <file>...\n");
                 return e_unsupported; // Return unsupported operation
             }
         }
@@ -84,7 +277,10 @@ int main(int argc, char *argv[]) // Main function with command-line arguments
                 // Validate decoding arguments and perform decoding
                 if (read_and_validate_decode_args(argv, &decInfo) == e_success)
                 {
-                    do_decoding(&decInfo); // Perform decoding
+                    if (do_decoding(&decInfo) != e_success) // Perform decoding
+                    {
+                        return e_failure; // Return failure
+                    }
                 }
                 else // Handle validation failure
                 {
@@ -96,10 +292,47 @@ int main(int argc, char *argv[]) // Main function with command-line arguments
             {
                 // Print help message for decoding
                 printf("For Decoding : \n");
-                printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt>\n");
+                printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> <optional - outputfile.txt> <optional - --range OFFSET:LENGTH>\n");
+                printf(COLOR_BOLD_BLUE "-d" COLOR_RESET " <inputfile.bmp> --list | --extract NAME <optional - outputfile>\n");
+                return e_unsupported; // Return unsupported operation
+            }
+        }
+        else if (!strcmp(argv[1], "-u")) // Check if the first argument is "-u"
+        {
+            if (argc >= 4) // Check if sufficient arguments are provided for updating
+            {
+                // Validate update arguments and perform update
+                if (read_and_validate_update_args(argv, &updInfo) == e_success)
+                {
+                    return do_update(&updInfo); // Perform update
+                }
+                else // Handle validation failure
+                {
+                    printf(COLOR_BOLD_SLOW_BLINKING_RED "Update read and validate failed\n" COLOR_RESET);
+                    return e_failure; // Return failure
+                }
+            }
+            else // Handle insufficient arguments for updating
+            {
+                // Print help message for updating
+                printf("For Updating : \n");
+                printf(COLOR_BOLD_BLUE "-u" COLOR_RESET " <stegofile.bmp> <secretfile.txt>\n");
                 return e_unsupported; // Return unsupported operation
             }
         }
+        else if (!strcmp(argv[1], "-a")) // Check if the first argument is "-a"
+        {
+            // Validate analysis arguments and perform analysis
+            if (read_and_validate_analyze_args(argc, argv, &anaInfo) == e_success)
+            {
+                return do_analysis(&anaInfo); // Perform analysis
+            }
+            else // Handle validation failure
+            {
+                printf(COLOR_BOLD_SLOW_BLINKING_RED "Analyze read and validate failed\n" COLOR_RESET);
+                return e_failure; // Return failure
+            }
+        }
     }
     return e_success; // Return success
 }
@@ -0,0 +1,44 @@
+#ifndef MATRIX_H // Include guard to prevent multiple inclusions of this header file
+#define MATRIX_H
+
+#include "Return_types.h" // Include user-defined types from types.h
+#include "Palette_function_header_file.h" // Include palette types for 8 bit images
+
+/*
+ * Matrix embedding with a Hamming code of rate K
+ * Secret bits are taken K at a time and carried by a
+ * group of 2^K - 1 image bytes. The XOR of the positions
+ * of all bytes with LSB 1 (the syndrome) is the K bits,
+ * and at most one byte per group is changed to reach it
+ */
+
+#define MATRIX_MIN_RATE 2                                // Define smallest rate, 3 image bytes carry 2 bits
+#define MATRIX_MAX_RATE 7                                // Define largest rate, 127 image bytes carry 7 bits
+#define MATRIX_MAX_GROUP ((1 << MATRIX_MAX_RATE) - 1)    // Define image bytes in the largest group
+#define MATRIX_CHUNK_GROUPS 512                          // Define groups embedded per image block
+#define MATRIX_CHUNK_SIZE(k) (MATRIX_CHUNK_GROUPS * (k) / 8) // Define secret bytes per image block, whole groups only
+
+typedef struct _MatrixChange // Structure to hold one image byte changed by matrix embedding
+{
+    long offset;            // Offset of the byte in the image block
+    unsigned char original; // Value of the byte before embedding
+} MatrixChange;
+
+/* Matrix function prototype */
+
+/* Image bytes in one group */
+uint matrix_group_size(uint k); // Function to get 2^K - 1
+
+/* Image bytes needed for a number of secret bytes */
+long matrix_cover_size(long size, uint k); // Function to get image bytes of all groups holding size bytes
+
+/* Syndrome of a group */
+uint matrix_syndrome(const char *group, uint n); // Function to XOR positions of bytes with LSB 1
+
+/* Embed a block of bytes into groups of image data */
+long matrix_embed_block(const char *data, long size, char *image_buffer, uint k, const PaletteInfo *palInfo, MatrixChange *changes); // Function to embed, count and optionally record changed image bytes
+
+/* Extract a block of bytes from groups of image data */
+void matrix_extract_block(char *data, long size, const char *image_buffer, uint k); // Function to collect syndromes into bytes
+
+#endif // End of include guard
@@ -0,0 +1,98 @@
+#include <stdio.h>  // Standard I/O library
+#include <string.h> // String manipulation functions
+#include "Matrix_function_header_file.h" // Header file for matrix embedding functions
+#include "Return_types.h"  // Include types header file
+
+/* Function Definitions */
+
+/* Image bytes in one group of rate K */
+uint matrix_group_size(uint k)
+{
+    return (1u << k) - 1; // 2^K - 1 positions give every non-zero K bit syndrome
+}
+
+/*
+ * Image bytes needed for secret data
+ * Description: 8 * size bits are split into groups of K bits,
+ * the last group is padded with zero bits
+ */
+long matrix_cover_size(long size, uint k)
+{
+    return (size * 8 + k - 1) / k * matrix_group_size(k); // Groups times image bytes per group
+}
+
+/*
+ * Syndrome of a group
+ * Description: The LSB is turned into an all zero or all one mask,
+ * so the loop has no branches and is vectorized at -O3
+ */
+uint matrix_syndrome(const char *group, uint n)
+{
+    const unsigned char *c = (const unsigned char *)group; // Image bytes as unsigned
+    uint s = 0;                                            // Syndrome
+    for (uint i = 0; i < n; i++)                           // Loop through bytes of group
+    {
+        s ^= (i + 1) & -(uint)(c[i] & 1); // Add position of bytes with LSB 1
+    }
+    return s; // Return syndrome
+}
+
+/*
+ * Embed a block of bytes into groups of image data
+ * Input: size bytes of data and matrix_cover_size(size, k) bytes of image data
+ * Output: Number of image bytes changed, and when changes is not NULL
+ * the offset and original value of each, one entry per group at most
+ * Description: The syndrome differs from the wanted bits in exactly the
+ * position of the one byte whose LSB has to flip. Palette indices move to
+ * the nearest colour with the other LSB instead of flipping blindly
+ */
+long matrix_embed_block(const char *data, long size, char *image_buffer, uint k, const PaletteInfo *palInfo, MatrixChange *changes)
+{
+    uint n = matrix_group_size(k); // Image bytes per group
+    long bits = size * 8;          // Secret bits in block
+    long changed = 0;              // Image bytes changed
+    for (long b = 0, start = 0; b < bits; b += k, start += n) // Loop through groups
+    {
+        uint m = 0;                  // Bits wanted in this group
+        for (uint j = 0; j < k; j++) // Collect K bits, MSB first
+        {
+            long p = b + j;                                                                  // Position of bit in block
+            uint bit = p < bits ? ((unsigned char)data[p >> 3] >> (7 - (p & 7))) & 1 : 0; // Pad last group with zeros
+            m = m << 1 | bit;
+        }
+        uint d = matrix_syndrome(image_buffer + start, n) ^ m; // Position to change, 0 if none
+        if (d != 0)
+        {
+            unsigned char *c = (unsigned char *)image_buffer + start + d - 1; // Byte to change
+            if (changes != NULL)                                              // Check if changes are recorded
+            {
+                changes[changed].offset = start + d - 1; // Remember byte before it changes
+                changes[changed].original = *c;
+            }
+            *c = palInfo->palettized ? palInfo->parity_lut[(*c & 1) ^ 1][*c] : *c ^ 1; // Flip its LSB
+            changed++;                                                                // Count changed byte
+        }
+    }
+    return changed; // Return number of changed bytes
+}
+
+/*
+ * Extract a block of bytes from groups of image data
+ * Input: size bytes to extract and the image data of their groups
+ * Output: Syndromes of the groups joined into bytes, MSB first
+ */
+void matrix_extract_block(char *data, long size, const char *image_buffer, uint k)
+{
+    uint n = matrix_group_size(k); // Image bytes per group
+    long bits = size * 8;          // Secret bits in block
+    memset(data, 0, size);         // Bits are OR-ed in
+    for (long b = 0; b < bits; b += k, image_buffer += n) // Loop through groups
+    {
+        uint s = matrix_syndrome(image_buffer, n); // K bits of this group
+        for (uint j = 0; j < k && b + j < bits; j++) // Spread bits, padding is dropped
+        {
+            long p = b + j;                                                     // Position of bit in block
+            data[p >> 3] |= ((s >> (k - 1 - j)) & 1) << (7 - (p & 7)); // Set bit, MSB first
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef PALETTE_H // Include guard to prevent multiple inclusions of this header file
+#define PALETTE_H
+
+#include "Return_types.h" // Include user-defined types from types.h
+
+/*
+ * Structure to store the colour table of an 8 bits
+ * per pixel BMP Image, and for every index the index
+ * nearest in colour that holds each LSB value, so
+ * embedding a bit is a single table lookup
+ */
+
+#define MAX_PALETTE_SIZE 256 // Maximum number of colours in an 8 bit palette
+
+typedef struct _PaletteInfo // Structure to hold palette information
+{
+    int palettized;                                      // Pixels are indices into the palette
+    uint palette_size;                                   // Number of palette entries in use
+    unsigned char palette[MAX_PALETTE_SIZE][4];          // Palette entries: blue, green, red, reserved
+    unsigned char parity_lut[2][MAX_PALETTE_SIZE];       // parity_lut[bit][index]: nearest index whose LSB is bit
+} PaletteInfo;
+
+/* Palette function prototype */
+
+/* Read palette and build parity swap table */
+Status read_bmp_palette(FILE *fptr_image, PaletteInfo *palInfo); // Function to check bits per pixel and prepare palettized covers
+
+/* Encode a byte into LSB of palette indices */
+void encode_byte_to_palette(char data, char *image_buffer, const PaletteInfo *palInfo); // Function to encode a byte by table lookup per pixel
+
+/* Get bits per pixel */
+uint get_bmp_bits_per_pixel(FILE *fptr_image); // Function to get the bits per pixel of a BMP image
+
+/* Get image size */
+uint get_image_size_for_bmp(FILE *fptr_image); // Function to get the number of image bytes that can hold data
+
+/* Get offset of pixel data */
+uint get_bmp_pixel_offset(FILE *fptr_image); // Function to get the offset of the BMP pixel array
+
+#endif // End of include guard
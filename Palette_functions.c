@@ -0,0 +1,140 @@
+#include <stdio.h>  // Standard I/O library
+#include <string.h> // String manipulation functions
+#include "Palette_function_header_file.h" // Header file for palette functions
+#include "Return_types.h"  // Include types header file
+
+#define COLOR_BOLD_SLOW_BLINKING_RED "\e[1;5;31m" // Define ANSI escape code for bold slow blinking red text
+#define COLOR_RESET "\e[0m"                       // Define ANSI escape code to reset text formatting
+#define COLOR_BOLD_GREEN "\e[1;32m"               // Define ANSI escape code for bold green text
+
+/* Function Definitions */
+
+/* Get bits per pixel
+ * Input: Image file ptr
+ * Output: Bits per pixel of the image
+ * Description: In BMP Image, bits per pixel is stored
+ * at offset 28. size is 2 bytes
+ */
+uint get_bmp_bits_per_pixel(FILE *fptr_image)
+{
+    unsigned short bpp = 0;                   // Variable to store bits per pixel
+    fseek(fptr_image, 28, SEEK_SET);          // Seek to 28th byte in BMP file
+    fread(&bpp, sizeof(bpp), 1, fptr_image);  // Read bits per pixel (2 bytes)
+    return bpp;                               // Return bits per pixel
+}
+
+/*
+ * Check every pixel index lies inside the palette
+ * Description: Reads the image bytes embedding may touch, block by block
+ */
+static Status check_palette_indices(FILE *fptr_image, uint offset, uint count)
+{
+    unsigned char buffer[65536];                   // Buffer to read pixel indices
+    long left = get_image_size_for_bmp(fptr_image); // Bytes embedding may touch
+    fseek(fptr_image, offset, SEEK_SET);            // Move file pointer to pixel data
+    while (left > 0)                                // Loop through pixels block by block
+    {
+        size_t n = left < (long)sizeof buffer ? (size_t)left : sizeof buffer; // Bytes in this block
+        n = fread(buffer, 1, n, fptr_image);                                  // Read block of indices
+        if (n == 0)
+        {
+            break; // Short images are rejected by the capacity check
+        }
+        unsigned char max = 0; // Largest index in block
+        for (size_t i = 0; i < n; i++)
+        {
+            max = buffer[i] > max ? buffer[i] : max;
+        }
+        if (max >= count) // Index points past the palette
+        {
+            return e_failure;
+        }
+        left -= n; // Move to next block
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Read palette and build parity swap table
+ * Input: Image file ptr
+ * Output: Palette and parity swap table for 8 bit images
+ * Description: Plain LSB replacement on indices jumps between
+ * unrelated colours. Instead, every index is paired once with the
+ * opposite parity index whose colour is closest, so embedding only
+ * ever moves a pixel to its nearest usable colour
+ * Return Value: e_success, or e_failure for unsupported images
+ */
+Status read_bmp_palette(FILE *fptr_image, PaletteInfo *palInfo)
+{
+    uint bpp = get_bmp_bits_per_pixel(fptr_image); // Get bits per pixel
+    palInfo->palettized = 0;                       // Assume direct colour
+    if (bpp == 16 || bpp == 24 || bpp == 32)       // Direct colour, LSBs of pixel bytes are used
+    {
+        return e_success; // Return success
+    }
+    if (bpp != 8) // Only 8 bit palettes are supported
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %u bits per pixel BMP files are not supported\n" COLOR_RESET, bpp); // Log error
+        return e_failure;                                                                                              // Return failure
+    }
+
+    uint header_size = 0, colors_used = 0;                     // Info header size and palette size
+    fseek(fptr_image, 14, SEEK_SET);                           // Info header size follows the file header
+    fread(&header_size, sizeof(int), 1, fptr_image);           // Read info header size (4 bytes)
+    fseek(fptr_image, 46, SEEK_SET);                           // Seek to number of colours used
+    fread(&colors_used, sizeof(int), 1, fptr_image);           // Read colours used (4 bytes), 0 means all
+    uint offset = get_bmp_pixel_offset(fptr_image);            // Palette ends where pixel data starts
+    uint room = offset > 14 + header_size ? (offset - 14 - header_size) / 4 : 0; // Entries that fit before pixel data
+    uint count = colors_used ? colors_used : MAX_PALETTE_SIZE; // Number of palette entries
+    count = count < room ? count : room;
+    count = count < MAX_PALETTE_SIZE ? count : MAX_PALETTE_SIZE;
+    fseek(fptr_image, 14 + header_size, SEEK_SET);              // Palette follows the info header
+    if (count < 2 || fread(palInfo->palette, 4, count, fptr_image) != count) // Need two colours to carry a bit
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Palette of 8 bit BMP file is unusable" COLOR_RESET); // Log error
+        return e_failure;                                                                              // Return failure
+    }
+    palInfo->palette_size = count; // Store number of entries
+    palInfo->palettized = 1;       // Pixels are palette indices
+
+    if (count < MAX_PALETTE_SIZE && check_palette_indices(fptr_image, offset, count) != e_success) // Swaps only exist inside the palette
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Pixels of 8 bit BMP file use colours missing from its palette" COLOR_RESET); // Log error
+        return e_failure;                                                                                                    // Return failure
+    }
+    memset(palInfo->parity_lut, 0, sizeof palInfo->parity_lut); // Entries past the palette are never looked up
+    for (uint v = 0; v < count; v++) // Pair every index with its nearest opposite parity colour
+    {
+        const unsigned char *c = palInfo->palette[v]; // Colour of this index
+        uint best = v ^ 1;                            // Fallback partner
+        long best_dist = -1;                          // Distance to best partner
+        for (uint u = (v & 1) ^ 1; u < count; u += 2) // Only opposite parity indices
+        {
+            const unsigned char *d = palInfo->palette[u];
+            long db = c[0] - d[0], dg = c[1] - d[1], dr = c[2] - d[2];
+            long dist = db * db + dg * dg + dr * dr; // Squared colour distance
+            if (best_dist < 0 || dist < best_dist)
+            {
+                best = u;
+                best_dist = dist;
+            }
+        }
+        palInfo->parity_lut[v & 1][v] = v;        // Index already has this parity
+        palInfo->parity_lut[(v & 1) ^ 1][v] = best; // Swap to nearest colour of the other parity
+    }
+    printf(COLOR_BOLD_GREEN "INFO: Using %u colour palette with nearest colour parity swaps\n" COLOR_RESET, count); // Log message
+    return e_success;                                                                                             // Return success
+}
+
+/*
+ * Encode a byte into LSB of palette indices
+ * Description: One table lookup per pixel and no branches; the same
+ * bit layout as encode_byte_tolsb, so decoding is unchanged
+ */
+void encode_byte_to_palette(char data, char *image_buffer, const PaletteInfo *palInfo)
+{
+    for (int i = 0; i < 8; i++) // Loop through all 8 bits of byte, MSB first
+    {
+        image_buffer[i] = palInfo->parity_lut[(data >> (7 - i)) & 1][(unsigned char)image_buffer[i]]; // Move pixel to index with wanted LSB
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef PIPELINE_H // Include guard to prevent multiple inclusions of this header file
+#define PIPELINE_H
+
+#include <stdatomic.h>                   // Include C11 atomics for the lock-free rings
+#include <pthread.h>                     // Include POSIX threads for sleeping on a ring
+#include "Encode_function_header_file.h" // Include encode header for EncodeInfo
+
+/*
+ * Structures to store information required for
+ * encoding secret file data with reading, embedding
+ * and writing overlapped on separate threads
+ * Cover blocks are reused and handed between the
+ * stages through single producer single consumer rings
+ * A stage that finds its ring empty or full spins briefly
+ * and then sleeps until the other side moves a block
+ */
+
+#define PIPELINE_DEPTH 4                                  // Cover blocks in flight between the stages
+#define PIPELINE_BLOCK_SIZE (MAX_DATA_CHUNK_SIZE * 8)     // Image bytes in one cover block
+#define PIPELINE_SPIN 64                                  // Ring checks before a stage goes to sleep
+
+typedef struct _PipelineBlock // Structure to hold one reusable cover block
+{
+    char image_data[PIPELINE_BLOCK_SIZE];   // Image bytes of this block
+    char secret_data[MAX_DATA_CHUNK_SIZE];  // Secret bytes to encode into this block
+    long image_size;                        // Number of image bytes in this block
+    long secret_size;                       // Number of secret bytes, 0 for the image tail
+    int last;                               // Marks the end of the stream
+} PipelineBlock;
+
+typedef struct _PipelineRing // Structure to hold a lock-free ring of block pointers
+{
+    PipelineBlock *slots[PIPELINE_DEPTH + 1]; // Ring slots, one spare to tell full from empty
+    atomic_uint head;                         // Next slot to pop, advanced by the consumer
+    atomic_uint tail;                         // Next slot to push, advanced by the producer
+    atomic_int waiters;                       // Stages sleeping on this ring
+    pthread_mutex_t lock;                     // Lock a sleeping stage waits under
+    pthread_cond_t moved;                     // Signalled when a block is pushed or popped
+} PipelineRing;
+
+typedef struct _PipelineInfo // Structure to hold pipeline state shared by the stages
+{
+    EncodeInfo *encInfo;                  // Encoding information of the job
+    PipelineBlock blocks[PIPELINE_DEPTH]; // Reusable cover blocks
+    PipelineRing free_ring;               // Empty blocks, writer to reader
+    PipelineRing read_ring;               // Read blocks, reader to embedder
+    PipelineRing encoded_ring;            // Encoded blocks, embedder to writer
+    atomic_int failed;                    // Set by any stage that hits an error
+} PipelineInfo;
+
+/* Pipeline function prototype */
+
+/* Encode secret file data and copy the image tail on three stages */
+Status encode_pipelined(EncodeInfo *encInfo); // Function to overlap reading, embedding and writing
+
+#endif // End of include guard
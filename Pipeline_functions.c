@@ -0,0 +1,258 @@
+#include <stdio.h>   // Standard I/O library
+#include <stdlib.h>  // Memory allocation functions
+#include <pthread.h> // POSIX threads for the reader and writer stages
+#include <sched.h>   // sched_yield during the bounded spin
+#include "Pipeline_function_header_file.h" // Header file for pipeline functions
+#include "Return_types.h"  // Include types header file
+
+/* Function Definitions */
+
+/* Push a block, returns 0 when the ring is full (producer side only) */
+static int ring_push(PipelineRing *ring, PipelineBlock *block)
+{
+    uint tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);          // Own index
+    uint next = (tail + 1) % (PIPELINE_DEPTH + 1);                               // Slot after tail
+    if (next == atomic_load_explicit(&ring->head, memory_order_acquire))          // Check if ring is full
+    {
+        return 0;
+    }
+    ring->slots[tail] = block;                                                    // Store block
+    atomic_store_explicit(&ring->tail, next, memory_order_release);               // Publish block
+    return 1;
+}
+
+/* Pop a block, returns NULL when the ring is empty (consumer side only) */
+static PipelineBlock *ring_pop(PipelineRing *ring)
+{
+    uint head = atomic_load_explicit(&ring->head, memory_order_relaxed);          // Own index
+    if (head == atomic_load_explicit(&ring->tail, memory_order_acquire))          // Check if ring is empty
+    {
+        return NULL;
+    }
+    PipelineBlock *block = ring->slots[head];                                     // Take block
+    atomic_store_explicit(&ring->head, (head + 1) % (PIPELINE_DEPTH + 1), memory_order_release); // Free slot
+    return block;
+}
+
+/* Wake a stage sleeping on the ring after a push or pop */
+static void ring_wake(PipelineRing *ring)
+{
+    atomic_thread_fence(memory_order_seq_cst); // Order the ring update before the waiter check
+    if (atomic_load_explicit(&ring->waiters, memory_order_relaxed) > 0)
+    {
+        pthread_mutex_lock(&ring->lock); // Sleeper is either waiting or still checking the ring
+        pthread_cond_broadcast(&ring->moved);
+        pthread_mutex_unlock(&ring->lock);
+    }
+}
+
+/*
+ * Push a block, waiting while the ring is full
+ * Description: Spins for a bounded number of checks, since the consumer
+ * usually frees a slot quickly, then sleeps so a stage blocked on disk
+ * costs no CPU
+ */
+static void ring_push_wait(PipelineRing *ring, PipelineBlock *block)
+{
+    for (int i = 0; i < PIPELINE_SPIN; i++) // Short spin for a free slot
+    {
+        if (ring_push(ring, block))
+        {
+            ring_wake(ring);
+            return;
+        }
+        if (i >= PIPELINE_SPIN / 2) // Second half of the spin lets other threads run
+        {
+            sched_yield();
+        }
+    }
+    pthread_mutex_lock(&ring->lock);
+    atomic_fetch_add(&ring->waiters, 1);       // Announce sleeper before the last check
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!ring_push(ring, block))            // Wait for the consumer to catch up
+    {
+        pthread_cond_wait(&ring->moved, &ring->lock);
+    }
+    atomic_fetch_sub(&ring->waiters, 1);
+    pthread_mutex_unlock(&ring->lock);
+    ring_wake(ring); // Consumer may be sleeping on the same ring
+}
+
+/* Pop a block, waiting while the ring is empty */
+static PipelineBlock *ring_pop_wait(PipelineRing *ring)
+{
+    PipelineBlock *block;
+    for (int i = 0; i < PIPELINE_SPIN; i++) // Short spin for a block
+    {
+        if ((block = ring_pop(ring)) != NULL)
+        {
+            ring_wake(ring);
+            return block;
+        }
+        if (i >= PIPELINE_SPIN / 2) // Second half of the spin lets other threads run
+        {
+            sched_yield();
+        }
+    }
+    pthread_mutex_lock(&ring->lock);
+    atomic_fetch_add(&ring->waiters, 1);       // Announce sleeper before the last check
+    atomic_thread_fence(memory_order_seq_cst);
+    while ((block = ring_pop(ring)) == NULL)   // Wait for the producer
+    {
+        pthread_cond_wait(&ring->moved, &ring->lock);
+    }
+    atomic_fetch_sub(&ring->waiters, 1);
+    pthread_mutex_unlock(&ring->lock);
+    ring_wake(ring); // Producer may be sleeping on the same ring
+    return block;
+}
+
+/* Prepare or release the sleeping support of the three rings */
+static void pipeline_rings_init(PipelineInfo *pipeInfo, int init)
+{
+    PipelineRing *rings[] = {&pipeInfo->free_ring, &pipeInfo->read_ring, &pipeInfo->encoded_ring};
+    for (int i = 0; i < 3; i++)
+    {
+        if (init)
+        {
+            pthread_mutex_init(&rings[i]->lock, NULL);
+            pthread_cond_init(&rings[i]->moved, NULL);
+        }
+        else
+        {
+            pthread_mutex_destroy(&rings[i]->lock);
+            pthread_cond_destroy(&rings[i]->moved);
+        }
+    }
+}
+
+/*
+ * Reader stage
+ * Description: Fills free blocks with secret data and the matching
+ * image bytes, then with the image tail, and marks the final block
+ */
+static void *pipeline_reader(void *arg)
+{
+    PipelineInfo *pipeInfo = arg;                  // Shared pipeline state
+    EncodeInfo *encInfo = pipeInfo->encInfo;       // Encoding information
+    long left = encInfo->size_secret_file;         // Secret bytes still to read
+    fseek(encInfo->fptr_secret, 0, SEEK_SET);      // Reset secret file pointer
+    for (;;)
+    {
+        PipelineBlock *block = ring_pop_wait(&pipeInfo->free_ring); // Take an empty block
+        block->last = 0;
+        if (left > 0) // Secret data region
+        {
+            long n = left < MAX_DATA_CHUNK_SIZE ? left : MAX_DATA_CHUNK_SIZE;      // Bytes in this block
+            block->secret_size = n;
+            block->image_size = n * 8;                                              // 8 image bytes per secret byte
+            if (fread(block->secret_data, 1, n, encInfo->fptr_secret) != (size_t)n || // Read chunk of secret file
+                fread(block->image_data, 1, n * 8, encInfo->fptr_src_image) != (size_t)n * 8) // Read matching image bytes
+            {
+                atomic_store(&pipeInfo->failed, 1); // Report read error
+                block->image_size = 0;
+                block->last = 1;
+            }
+            left -= n;
+        }
+        else // Image tail, copied unchanged
+        {
+            block->secret_size = 0;
+            block->image_size = fread(block->image_data, 1, PIPELINE_BLOCK_SIZE, encInfo->fptr_src_image); // Read next tail block
+            block->last = block->image_size == 0;                                                           // Stop at end of image
+        }
+        ring_push_wait(&pipeInfo->read_ring, block); // Hand block to embedder
+        if (block->last)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Writer stage
+ * Description: Writes encoded blocks in order and returns them to
+ * the reader; keeps draining after an error so no stage blocks
+ */
+static void *pipeline_writer(void *arg)
+{
+    PipelineInfo *pipeInfo = arg;            // Shared pipeline state
+    EncodeInfo *encInfo = pipeInfo->encInfo; // Encoding information
+    for (;;)
+    {
+        PipelineBlock *block = ring_pop_wait(&pipeInfo->encoded_ring); // Take an encoded block
+        int last = block->last;                                        // Block is reused once returned
+        if (block->image_size > 0 && !atomic_load(&pipeInfo->failed) &&
+            fwrite(block->image_data, 1, block->image_size, encInfo->fptr_stego_image) != (size_t)block->image_size) // Write block
+        {
+            atomic_store(&pipeInfo->failed, 1); // Report write error
+        }
+        ring_push_wait(&pipeInfo->free_ring, block); // Return block to reader
+        if (last)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Encode secret file data and copy the image tail on three stages
+ * Description: A reader thread and a writer thread run around the
+ * embedding stage on the calling thread, so disk reads, LSB encoding
+ * and disk writes of consecutive blocks overlap
+ */
+Status encode_pipelined(EncodeInfo *encInfo)
+{
+    printf(COLOR_BOLD_GREEN "INFO: Encoding %s File Data and Left Over Data (pipelined)\n" COLOR_RESET, encInfo->secret_fname); // Log message
+    PipelineInfo *pipeInfo = calloc(1, sizeof *pipeInfo);                                                                      // Allocate pipeline state and blocks
+    if (pipeInfo == NULL)                                                                                                      // Check if allocation failed
+    {
+        return e_failure; // Return failure
+    }
+    pipeInfo->encInfo = encInfo;              // Share encoding information
+    pipeline_rings_init(pipeInfo, 1);         // Locks for stages that have to sleep
+    for (int i = 0; i < PIPELINE_DEPTH; i++)  // All blocks start empty
+    {
+        ring_push(&pipeInfo->free_ring, &pipeInfo->blocks[i]);
+    }
+    pthread_t reader, writer; // Reader and writer threads
+    if (pthread_create(&writer, NULL, pipeline_writer, pipeInfo) != 0) // Start writer stage
+    {
+        pipeline_rings_init(pipeInfo, 0);
+        free(pipeInfo);
+        return e_failure; // Return failure
+    }
+    if (pthread_create(&reader, NULL, pipeline_reader, pipeInfo) != 0) // Start reader stage
+    {
+        PipelineBlock *block = ring_pop(&pipeInfo->free_ring); // Send an empty final block to stop the writer
+        block->image_size = 0;
+        block->last = 1;
+        ring_push_wait(&pipeInfo->encoded_ring, block);
+        pthread_join(writer, NULL); // Wait for writer
+        pipeline_rings_init(pipeInfo, 0);
+        free(pipeInfo);
+        return e_failure; // Return failure
+    }
+    for (;;) // Embedding stage
+    {
+        PipelineBlock *block = ring_pop_wait(&pipeInfo->read_ring); // Take a read block
+        if (block->secret_size > 0)                                 // Tail blocks pass through unchanged
+        {
+            encode_data_block(encInfo, block->secret_data, block->secret_size, block->image_data); // Encode block into LSBs
+        }
+        int last = block->last;                           // Block belongs to writer after push
+        ring_push_wait(&pipeInfo->encoded_ring, block);   // Hand block to writer
+        if (last)
+        {
+            break;
+        }
+    }
+    pthread_join(reader, NULL); // Wait for reader
+    pthread_join(writer, NULL); // Wait for writer
+    Status status = atomic_load(&pipeInfo->failed) ? e_failure : e_success; // Collect stage errors
+    pipeline_rings_init(pipeInfo, 0);                                       // Release ring locks
+    free(pipeInfo);                                                         // Release pipeline state
+    return status;                                                          // Return status
+}
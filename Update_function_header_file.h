@@ -0,0 +1,69 @@
+#ifndef UPDATE_H // Include guard to prevent multiple inclusions of this header file
+#define UPDATE_H
+
+#include "Return_types.h" // Include user-defined types from types.h
+#include "Magic_string.h" // Include shared block size
+#include "Palette_function_header_file.h" // Include palette types for 8 bit images
+
+/*
+ * Structure to store information required for
+ * replacing the secret file of an existing stego Image
+ * in place, rewriting only image bytes whose LSBs change
+ */
+
+#define COLOR_BOLD_SLOW_BLINKING_RED "\e[1;5;31m" // Define bold slow blinking red text color
+#define COLOR_RESET "\e[0m"                       // Define reset text formatting
+#define COLOR_BOLD_GREEN "\e[1;32m"               // Define bold green text color
+#define MAX_FILE_SUFFIX 4                         // Define maximum file suffix length
+
+typedef struct _UpdateInfo // Define a structure to hold update information
+{
+    /* Stego Image Info */
+    char *stego_image_fname; // Pointer to stego image file name
+    FILE *fptr_stego_image;  // File pointer for stego image, opened for update
+    uint image_capacity;     // Capacity of the image to hold data
+    PaletteInfo palette;     // Palette and parity swap table of 8 bit images
+    long header_offset;      // Offset of the encoded header, start of pixel data
+    long data_offset;        // Offset of first secret data block in the image
+
+    /* Secret File Info */
+    char *secret_fname;                         // Pointer to new secret file name
+    FILE *fptr_secret;                          // File pointer for new secret file
+    char extn_secret_file[MAX_FILE_SUFFIX + 1]; // Extension of the new secret file
+    long size_secret_file;                      // Size of the new secret file
+    long old_size_secret_file;                  // Size of the secret file currently in the image
+
+    /* Statistics */
+    long blocks_total;     // Number of blocks compared
+    long blocks_rewritten; // Number of blocks that had to be written
+    long bytes_rewritten;  // Number of image bytes written
+
+} UpdateInfo;
+
+/* Update function prototype */
+
+/* Read and validate Update args from argv */
+Status read_and_validate_update_args(char *argv[], UpdateInfo *updInfo); // Validate update arguments
+
+/* Perform the update */
+Status do_update(UpdateInfo *updInfo); // Replace secret file in place
+
+/* Diff and rewrite one region */
+Status update_region(UpdateInfo *updInfo, long image_offset, const char *data, long size); // Rewrite only changed image bytes of a region
+
+/* Get image size */
+uint get_image_size_for_bmp(FILE *fptr_image); // Get the size of the BMP image
+
+/* Get file size */
+uint get_file_size(FILE *fptr); // Get the size of a file
+
+/* Encode a block of bytes into LSB of image data */
+void encode_lsb_block(const char *data, long size, char *image_buffer, const PaletteInfo *palInfo); // Encode size bytes into 8 * size image bytes
+
+/* Decode a block of bytes from LSB of image data */
+Status decode_data_block(char *data, long size, const char *image_buffer); // Decode size bytes from 8 * size image bytes
+
+/* Build the header encoded before the secret data */
+void build_stego_header(char *header, const char *extn, long size, uint matrix_rate); // Lay out STEGO_HEADER_SIZE header bytes
+
+#endif // End of include guard
@@ -0,0 +1,197 @@
+#include <stdio.h>  // Include standard input/output library
+#include <string.h> // Include string manipulation library
+#include "Update_function_header_file.h" // Include update header file
+#include "Return_types.h"  // Include types header file
+#include "Magic_string.h" // Include Magic_string header file
+
+/* Function Definitions */
+
+/*
+ * Read and validate Update args from argv
+ * Inputs: -u <stegofile.bmp> <secretfile.txt>
+ * Output: Stego image opened for update and new secret file
+ * Return Value: e_success or e_failure, on invalid arguments
+ */
+Status read_and_validate_update_args(char *argv[], UpdateInfo *updInfo)
+{
+    if (!strstr(argv[2], ".bmp")) // Check if stego image file is not BMP
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid Stego Image File. Only BMP files are allowed" COLOR_RESET); // Log error
+        return e_failure;                                                                                             // Return failure
+    }
+    if (!strstr(argv[3], ".txt")) // Check if secret file is not TXT
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid Secret File. Only TXT files are allowed" COLOR_RESET); // Log error
+        return e_failure;                                                                                        // Return failure
+    }
+    updInfo->stego_image_fname = argv[2];                  // Set stego image file name
+    updInfo->secret_fname = argv[3];                       // Set secret file name
+    char name[FILENAME_MAX];                               // Copy of secret file name to split
+    strncpy(name, updInfo->secret_fname, sizeof name - 1); // Keep argv intact for opening the file
+    name[sizeof name - 1] = '\0';
+    strtok(name, ".");             // Extract file name without extension, like the encoder
+    char *ext = strtok(NULL, "."); // Extract file extension
+    if (ext == NULL)               // Check if name has nothing after its first dot
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid Secret File. Only TXT files are allowed" COLOR_RESET); // Log error
+        return e_failure;                                                                                        // Return failure
+    }
+    strncpy(updInfo->extn_secret_file, ext, MAX_FILE_SUFFIX); // Copy extension
+    updInfo->extn_secret_file[MAX_FILE_SUFFIX] = '\0';
+
+    updInfo->fptr_stego_image = fopen(updInfo->stego_image_fname, "r+"); // Open stego image for reading and writing in place
+    if (updInfo->fptr_stego_image == NULL)                               // Check if file opening failed
+    {
+        perror("fopen");                                                                                                         // Print error message
+        fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open file %s\n" COLOR_RESET, updInfo->stego_image_fname); // Log error
+        return e_failure;                                                                                                        // Return failure
+    }
+    updInfo->fptr_secret = fopen(updInfo->secret_fname, "r"); // Open secret file in read mode
+    if (updInfo->fptr_secret == NULL)                         // Check if file opening failed
+    {
+        perror("fopen");                                                                                                    // Print error message
+        fprintf(stderr, COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Unable to open file %s\n" COLOR_RESET, updInfo->secret_fname); // Log error
+        return e_failure;                                                                                                   // Return failure
+    }
+    char data[2];                                                                    // Buffer to read BMP signature
+    if (fread(data, 1, 2, updInfo->fptr_stego_image) != 2 || data[0] != 0x42 || data[1] != 0x4d) // Check if BMP signature is valid
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Invalid Stego Image File. Only BMP files are allowed" COLOR_RESET); // Log error
+        return e_failure;                                                                                             // Return failure
+    }
+    updInfo->image_capacity = get_image_size_for_bmp(updInfo->fptr_stego_image); // Get image capacity
+    if (read_bmp_palette(updInfo->fptr_stego_image, &updInfo->palette) != e_success) // Prepare parity swaps for 8 bit images
+    {
+        return e_failure; // Return failure
+    }
+    updInfo->size_secret_file = get_file_size(updInfo->fptr_secret);             // Get size of new secret file
+    if (updInfo->image_capacity < (STEGO_HEADER_SIZE + updInfo->size_secret_file) * 8) // Check if image capacity is insufficient
+    {
+        puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Image is too small to hold the new secret file" COLOR_RESET); // Log error
+        return e_failure;                                                                                       // Return failure
+    }
+    return e_success; // Return success
+}
+
+/*
+ * Diff and rewrite one region
+ * Inputs: Image offset of the region and the data it should hold
+ * Description: The region is read, the bytes currently held in its
+ * LSBs are compared with data, and only the span between the first
+ * and last differing byte is encoded and written back
+ */
+Status update_region(UpdateInfo *updInfo, long image_offset, const char *data, long size)
+{
+    char str[MAX_DATA_CHUNK_SIZE * 8]; // Buffer to store image bytes of the region
+    long first = -1, last = -1;        // First and last byte that differ
+    fseek(updInfo->fptr_stego_image, image_offset, SEEK_SET);                    // Move file pointer to region
+    if (fread(str, 1, size * 8, updInfo->fptr_stego_image) != (size_t)size * 8) // Read 8 image bytes per data byte
+    {
+        return e_failure; // Return failure
+    }
+    char old[MAX_DATA_CHUNK_SIZE];      // Buffer to store bytes currently held
+    decode_data_block(old, size, str); // Decode region from LSBs
+    for (long i = 0; i < size; i++)    // Compare each byte held in the image
+    {
+        if (old[i] != data[i]) // Remember span of changed bytes
+        {
+            first = first < 0 ? i : first;
+            last = i;
+        }
+    }
+    updInfo->blocks_total++; // One more block compared
+    if (first < 0)           // Region already holds data
+    {
+        return e_success; // Nothing to write
+    }
+    encode_lsb_block(data + first, last - first + 1, str + first * 8, &updInfo->palette); // Encode changed span only
+    fseek(updInfo->fptr_stego_image, image_offset + first * 8, SEEK_SET);                               // Move file pointer to changed span
+    if (fwrite(str + first * 8, 1, (last - first + 1) * 8, updInfo->fptr_stego_image) != (size_t)(last - first + 1) * 8) // Write changed span in place
+    {
+        return e_failure; // Return failure
+    }
+    updInfo->blocks_rewritten++;                     // One more block written
+    updInfo->bytes_rewritten += (last - first + 1) * 8; // Count image bytes written
+    return e_success;                                // Return success
+}
+
+/* Read the header currently held in the image */
+static Status update_read_header(UpdateInfo *updInfo, char *header)
+{
+    char str[STEGO_HEADER_SIZE * 8];                                                          // Buffer to store image bytes of header
+    uint magic_len = strlen(MAGIC_STRING);                                                     // Length of magic string
+    updInfo->header_offset = get_bmp_pixel_offset(updInfo->fptr_stego_image);                 // Header starts at pixel data
+    fseek(updInfo->fptr_stego_image, updInfo->header_offset, SEEK_SET);                        // Move file pointer to pixel data offset
+    if (fread(str, 1, sizeof str, updInfo->fptr_stego_image) != sizeof str)                   // Read header blocks
+    {
+        return e_failure; // Return failure
+    }
+    decode_data_block(header, STEGO_HEADER_SIZE, str); // Decode header bytes
+    if (memcmp(header, MAGIC_STRING, magic_len)) // Check magic string
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %s does not hold a secret file\n" COLOR_RESET, updInfo->stego_image_fname); // Log error
+        return e_failure;                                                                                                      // Return failure
+    }
+    if (((unsigned char)header[magic_len + 4 - 1 - EMBED_MODE_SHIFT / 8] & EMBED_MODE_MASK) != 0) // Embedding mode is kept above the extension size
+    {
+        printf(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: %s is matrix embedded and cannot be updated in place\n" COLOR_RESET, updInfo->stego_image_fname); // Log error
+        return e_failure;                                                                                                                         // Return failure
+    }
+    const unsigned char *size = (const unsigned char *)header + STEGO_HEADER_SIZE - 4;                      // File size is the last header field
+    updInfo->old_size_secret_file = (long)size[0] << 24 | size[1] << 16 | size[2] << 8 | size[3];            // Join bytes, MSB first
+    updInfo->data_offset = updInfo->header_offset + STEGO_HEADER_SIZE * 8;                                 // Secret data follows the header
+    return e_success;                                                                                       // Return success
+}
+
+/*
+ * Perform the update
+ * Description: Header and secret data are compared block by block
+ * with what the image already holds; unchanged blocks are never
+ * written, so a small change to the secret dirties only a few pages
+ */
+Status do_update(UpdateInfo *updInfo)
+{
+    puts(COLOR_BOLD_GREEN "INFO: ## Update Procedure Started ##" COLOR_RESET); // Log message
+    char header[STEGO_HEADER_SIZE];                                           // Header currently held
+    Status status = update_read_header(updInfo, header);                       // Read header from image
+    long size = updInfo->size_secret_file;                                     // Size of new secret file
+    if (status == e_success)
+    {
+        printf(COLOR_BOLD_GREEN "INFO: Replacing %ld byte secret file with %ld bytes\n" COLOR_RESET, updInfo->old_size_secret_file, size); // Log message
+        build_stego_header(header, updInfo->extn_secret_file, size, 0);                      // New header, update keeps plain LSB
+        status = update_region(updInfo, updInfo->header_offset, header, STEGO_HEADER_SIZE); // Rewrite header only if it changed
+        if (status != e_success)
+        {
+            puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Failed to update header" COLOR_RESET); // Log error
+        }
+    }
+
+    char sec[MAX_DATA_CHUNK_SIZE];                        // Buffer to store a chunk of new secret file
+    fseek(updInfo->fptr_secret, 0, SEEK_SET);             // Reset secret file pointer
+    for (long done = 0; done < size && status == e_success;) // Loop through new secret file chunk by chunk
+    {
+        long n = size - done < MAX_DATA_CHUNK_SIZE ? size - done : MAX_DATA_CHUNK_SIZE; // Bytes in this chunk
+        if (fread(sec, 1, n, updInfo->fptr_secret) != (size_t)n ||                    // Read chunk of secret file
+            update_region(updInfo, updInfo->data_offset + done * 8, sec, n) != e_success) // Rewrite only if it changed
+        {
+            puts(COLOR_BOLD_SLOW_BLINKING_RED "ERROR: Failed to update secret file data" COLOR_RESET); // Log error
+            status = e_failure;
+        }
+        done += n; // Move to next chunk
+    }
+    fclose(updInfo->fptr_secret); // Done with secret file
+    updInfo->fptr_secret = NULL;
+    if (fclose(updInfo->fptr_stego_image) != 0) // Flush and close stego image
+    {
+        perror("fclose");   // Print error message
+        status = e_failure; // Unflushed output is a failure
+    }
+    updInfo->fptr_stego_image = NULL; // Stego image is closed
+    if (status != e_success)
+    {
+        return e_failure; // Return failure
+    }
+    printf(COLOR_BOLD_GREEN "INFO: Rewrote %ld of %ld blocks (%ld image bytes)\n" COLOR_RESET, updInfo->blocks_rewritten, updInfo->blocks_total, updInfo->bytes_rewritten); // Log statistics
+    puts(COLOR_BOLD_GREEN "INFO: ## Update Done Successfully ##" COLOR_RESET);                                                                                             // Log completion
+    return e_success;                                                                                                                                                       // Return success
+}